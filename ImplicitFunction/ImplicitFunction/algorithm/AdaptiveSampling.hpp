@@ -0,0 +1,168 @@
+#ifndef __ADAPTIVE_SAMPLING_HPP__
+#define __ADAPTIVE_SAMPLING_HPP__
+
+#define ADAPTIVE_COARSE_CELL 16
+#define ADAPTIVE_SAFETY 2.0f
+#include "../algorithm/ImplicitFunction.hpp"
+#include "../algorithm/MarchingSquares.hpp"
+#include <Eigen/Dense>
+#include <atomic>
+#include <cmath>
+#include <vector>
+
+struct AdaptiveStatistics {
+	int evaluations = 0;
+	int leafCells = 0;
+};
+
+// ĲӦsampleImplicitFunctionͬSTEPxy
+// ADAPTIVE_COARSE_CELLλСĴֵԪֵֻϸֵֿܰĵԪ
+// ߽Լ㴦f = 0߽ԼĵԪһϸֵ֣߾ÿԼ㸽©
+// ൥Ԫýǵݶȹ|f|ı仯ֻʽжϣԼԶȵԪϸֵֿ©
+// ҪʱرADAPTIVE_MODEsampleImplicitFunction()ֵ
+// ȨϸLipschitzϽsum(|w_i| * sup|grad phi|) + |P|ʱɶԵı߽硢ԼȨط෴
+// ϽʵݶȴĸеԪҪϸ֣ã
+class AdaptiveSampler {
+public:
+	AdaptiveSampler(const ImplicitFunctionModel& model)
+		: model(model),
+		xNum((model.cols + STEP - 1) / STEP),
+		yNum((model.rows + STEP - 1) / STEP),
+		values(xNum * yNum),
+		gradientNorms(xNum * yNum),
+		states(xNum * yNum),
+		anchorSums(xNum * yNum, 0) {
+		// anchorSums[i * yNum + j]ΪλԪ[0, i)  [0, j)б߽Լĸ
+		if (xNum < 2 || yNum < 2) {
+			return;
+		}
+		for (const auto& constraint : model.constraints) {
+			if (constraint.second != 0.0f) {
+				continue;
+			}
+			int i = std::max(0, std::min(xNum - 2, static_cast<int>(std::floor(constraint.first.x() / STEP))));
+			int j = std::max(0, std::min(yNum - 2, static_cast<int>(std::floor(constraint.first.y() / STEP))));
+			anchorSums[(i + 1) * yNum + j + 1]++;
+		}
+		for (int i = 1; i < xNum; i++) {
+			for (int j = 1; j < yNum; j++) {
+				anchorSums[i * yNum + j] += anchorSums[(i - 1) * yNum + j] + anchorSums[i * yNum + j - 1] - anchorSums[(i - 1) * yNum + j - 1];
+			}
+		}
+	}
+
+	// õֵߣֻϸֵĵԪֵĲֵ
+	void sample(std::vector<Polyline>& polylines, AdaptiveStatistics* statistics = nullptr) {
+		int xCells = (xNum - 2) / ADAPTIVE_COARSE_CELL + 1;
+		int yCells = (yNum - 2) / ADAPTIVE_COARSE_CELL + 1;
+		std::vector<std::vector<MarchingSegment>> cellSegments(xCells * yCells);
+		std::vector<int> cellLeaves(xCells * yCells, 0);
+#pragma omp parallel for schedule(dynamic)
+		for (int c = 0; c < xCells * yCells; c++) {
+			int i0 = c / yCells * ADAPTIVE_COARSE_CELL, j0 = c % yCells * ADAPTIVE_COARSE_CELL;
+			int i1 = std::min(i0 + ADAPTIVE_COARSE_CELL, xNum - 1), j1 = std::min(j0 + ADAPTIVE_COARSE_CELL, yNum - 1);
+			refine(i0, j0, i1, j1, cellSegments[c], cellLeaves[c]);
+		}
+		std::vector<MarchingSegment> segments;
+		for (const auto& s : cellSegments) {
+			segments.insert(segments.end(), s.begin(), s.end());
+		}
+		chainSegments(segments, polylines);
+		if (statistics) {
+			statistics->evaluations = 0;
+			statistics->leafCells = 0;
+			for (const auto& state : states) {
+				statistics->evaluations += state.load() == EVALUATED;
+			}
+			for (int leaves : cellLeaves) {
+				statistics->leafCells += leaves;
+			}
+		}
+	}
+
+private:
+	enum State : unsigned char { EMPTY, EVALUATING, EVALUATED };
+
+	const ImplicitFunctionModel& model;
+	int xNum, yNum;
+	std::vector<float> values, gradientNorms;
+	std::vector<std::atomic<unsigned char>> states;
+	std::vector<int> anchorSums;
+
+	// (i, j)ֵÿֵֻһΣڴֵԪĵȵֵ߳
+	float value(int i, int j) {
+		int index = i * yNum + j;
+		unsigned char expected = EMPTY;
+		if (states[index].compare_exchange_strong(expected, EVALUATING)) {
+			Eigen::Vector3f gradient;
+			values[index] = implicitFunctionValueAndGradient(Eigen::Vector3f(i * STEP, j * STEP, 0.0f), model, gradient);
+			gradientNorms[index] = gradient.head<2>().norm();
+			states[index].store(EVALUATED, std::memory_order_release);
+		}
+		else {
+			while (states[index].load(std::memory_order_acquire) != EVALUATED) {
+			}
+		}
+		return values[index];
+	}
+
+	// Ԫб߽Լ
+	bool containsAnchor(int i0, int j0, int i1, int j1) const {
+		return anchorSums[i1 * yNum + j1] - anchorSums[i0 * yNum + j1] - anchorSums[i1 * yNum + j0] + anchorSums[i0 * yNum + j0] > 0;
+	}
+
+	// Ԫڿֵ㣺ǵŲͬԪб߽Լ㣬߽ǵݶȹƲܱ֤|f|ڵԪڲΪ0
+	bool mayContainZero(int i0, int j0, int i1, int j1) {
+		int corners[4][2] = { { i0, j0 }, { i1, j0 }, { i1, j1 }, { i0, j1 } };
+		float maxAbsValue = 0.0f, maxGradient = 0.0f;
+		bool positive = false, negative = false;
+		for (const auto& corner : corners) {
+			float v = value(corner[0], corner[1]);
+			positive |= v > 0.0f;
+			negative |= v <= 0.0f;
+			maxAbsValue = std::max(maxAbsValue, std::abs(v));
+			maxGradient = std::max(maxGradient, gradientNorms[corner[0] * yNum + corner[1]]);
+		}
+		if ((positive && negative) || containsAnchor(i0, j0, i1, j1)) {
+			return true;
+		}
+		float diagonal = std::hypot(static_cast<float>(i1 - i0), static_cast<float>(j1 - j0)) * STEP;
+		return maxAbsValue <= ADAPTIVE_SAFETY * maxGradient * diagonal;
+	}
+
+	void refine(int i0, int j0, int i1, int j1,
+		std::vector<MarchingSegment>& segments, int& leaves) {
+		if (!mayContainZero(i0, j0, i1, j1)) {
+			return;
+		}
+		if (i1 - i0 == 1 && j1 - j0 == 1) {
+			leaves++;
+			marchingSquaresCells([this](int i, int j) { return value(i, j); }, yNum, STEP, i0, i1, j0, j1, segments);
+			return;
+		}
+		int mi = i1 - i0 > 1 ? (i0 + i1) / 2 : i1;
+		int mj = j1 - j0 > 1 ? (j0 + j1) / 2 : j1;
+		refine(i0, j0, mi, mj, segments, leaves);
+		if (mi != i1) {
+			refine(mi, j0, i1, mj, segments, leaves);
+		}
+		if (mj != j1) {
+			refine(i0, mj, mi, j1, segments, leaves);
+		}
+		if (mi != i1 && mj != j1) {
+			refine(mi, mj, i1, j1, segments, leaves);
+		}
+	}
+};
+
+// Ӧõֵ
+void adaptiveSampleImplicitFunction(
+	const ImplicitFunctionModel& model,
+	std::vector<Polyline>& polylines,
+	AdaptiveStatistics* statistics = nullptr)
+{
+	AdaptiveSampler sampler(model);
+	sampler.sample(polylines, statistics);
+}
+
+#endif
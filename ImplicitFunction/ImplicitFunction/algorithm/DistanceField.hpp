@@ -0,0 +1,162 @@
+#ifndef __DISTANCE_FIELD_HPP__
+#define __DISTANCE_FIELD_HPP__
+
+#include "../algorithm/ImplicitFunction.hpp"
+#include "../algorithm/ImageProcess.hpp"
+#include <Eigen/Dense>
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+// ž볡ĲֵʽͬSTEPxyڲΪڱ߽總뾶һ
+// ߽Ϊ0OFFSETΪ1ֵΪ߽зžOFFSETֱӺͲֵļһֵ
+// Է飬ΪO()
+
+// ɱպϱ߽contour꣬׵㲻ĩβظõrows  colsͼƬķž볡߽3ʱfalse
+// 룺ÿÿȡ㣬ΪӲ±ߵıţȰFelzenszwalb-HuttenlocherĿɷ㷨
+// ȷŷϾ任õÿأһÿһҲӣڶÿ
+// ߵ°磻ȡڵı߼ǰߵľ룬õصľ
+// ⣺ÿˮƽ߽Ľ㲢򣬰ߵĽżж
+bool signedDistanceField(const std::vector<Eigen::Vector2f>& contour, int rows, int cols, std::vector<float>& field)
+{
+	int n = contour.size();
+	if (n < 3) {
+		return false;
+	}
+	int xNum = (cols + STEP - 1) / STEP;
+	int yNum = (rows + STEP - 1) / STEP;
+
+	// seeds[y * cols + x]Ϊ(y, x)ıߵıţʱΪ-1
+	std::vector<int> seeds(static_cast<size_t>(rows) * cols, -1);
+	for (int k = 0; k < n; k++) {
+		const Eigen::Vector2f& a = contour[k];
+		const Eigen::Vector2f& b = contour[(k + 1) % n];
+		int num = static_cast<int>(std::ceil((b - a).norm() * 2.0f)) + 1;
+		for (int s = 0; s <= num; s++) {
+			Eigen::Vector2f point = a + (b - a) * (static_cast<float>(s) / num);
+			int x = std::max(0, std::min(cols - 1, static_cast<int>(std::lround(point.x()))));
+			int y = std::max(0, std::min(rows - 1, static_cast<int>(std::lround(point.y()))));
+			seeds[static_cast<size_t>(y) * cols + x] = k;
+		}
+	}
+
+	// nearestSeeds[i * rows + y]Ϊyx = i * STEPصУûʱΪ-1
+	std::vector<int> nearestSeeds(static_cast<size_t>(xNum) * rows);
+#pragma omp parallel for
+	for (int y = 0; y < rows; y++) {
+		const int* row = &seeds[static_cast<size_t>(y) * cols];
+		int i = 0, pre = -1;
+		for (int x = 0; x < cols && i < xNum; x++) {
+			if (row[x] < 0) {
+				continue;
+			}
+			// xi * STEPұߵĵһӣ֮ǰĲжprex֮
+			for (; i < xNum && i * STEP <= x; i++) {
+				int sampleX = i * STEP;
+				nearestSeeds[static_cast<size_t>(i) * rows + y] = pre >= 0 && sampleX - pre <= x - sampleX ? pre : x;
+			}
+			pre = x;
+		}
+		for (; i < xNum; i++) {
+			nearestSeeds[static_cast<size_t>(i) * rows + y] = pre;
+		}
+	}
+
+	// crossings[j]Ϊˮƽy = j * STEP߽Ľx꣬߰¶˱ա϶˿룬ʱظ
+	std::vector<std::vector<float>> crossings(yNum);
+	for (int k = 0; k < n; k++) {
+		const Eigen::Vector2f& a = contour[k];
+		const Eigen::Vector2f& b = contour[(k + 1) % n];
+		float y0 = std::min(a.y(), b.y()), y1 = std::max(a.y(), b.y());
+		for (int j = std::max(0, static_cast<int>(std::ceil(y0 / STEP))); j < yNum && j * STEP < y1; j++) {
+			float t = (j * STEP - a.y()) / (b.y() - a.y());
+			crossings[j].push_back(a.x() + t * (b.x() - a.x()));
+		}
+	}
+	for (auto& row : crossings) {
+		std::sort(row.begin(), row.end());
+	}
+
+	field.resize(static_cast<size_t>(xNum) * yNum);
+#pragma omp parallel
+	{
+		// °е߶vߵĽz
+		std::vector<int> v(rows);
+		std::vector<double> z(rows + 1);
+		std::vector<char> inside(yNum);
+#pragma omp for
+		for (int i = 0; i < xNum; i++) {
+			const int* columns = &nearestSeeds[static_cast<size_t>(i) * rows];
+			int sampleX = i * STEP;
+			for (int j = 0; j < yNum; j++) {
+				// ߵĽΪʱڲ
+				auto left = std::lower_bound(crossings[j].begin(), crossings[j].end(), static_cast<float>(sampleX));
+				inside[j] = (left - crossings[j].begin()) % 2;
+			}
+			auto cost = [&](int y) {
+				double dx = columns[y] - sampleX;
+				return dx * dx + static_cast<double>(y) * y;
+			};
+			int k = -1;
+			for (int y = 0; y < rows; y++) {
+				if (columns[y] < 0) {
+					continue;
+				}
+				double s = -std::numeric_limits<double>::infinity();
+				while (k >= 0) {
+					s = (cost(y) - cost(v[k])) / (2.0 * (y - v[k]));
+					if (s > z[k]) {
+						break;
+					}
+					k--;
+				}
+				k++;
+				v[k] = y;
+				z[k] = k == 0 ? -std::numeric_limits<double>::infinity() : s;
+				z[k + 1] = std::numeric_limits<double>::infinity();
+			}
+			for (int j = 0, l = 0; j < yNum; j++) {
+				int sampleY = j * STEP;
+				while (z[l + 1] < sampleY) {
+					l++;
+				}
+				int edge = seeds[static_cast<size_t>(v[l]) * cols + columns[v[l]]];
+				Eigen::Vector2f point(sampleX, sampleY);
+				float distance = FLT_MAX;
+				for (int e = edge - 1; e <= edge + 1; e++) {
+					int e0 = (e + n) % n;
+					distance = std::min(distance, segmentDistance(point, contour[e0], contour[(e0 + 1) % n]));
+				}
+				field[static_cast<size_t>(i) * yNum + j] = (inside[j] ? distance : -distance) / OFFSET;
+			}
+		}
+	}
+	return true;
+}
+
+// ͼƬõž볡ȡʽͱ߽processImage4()ͬȡıպϱ߽
+bool distanceFieldImage(const char* imagePath, int& rows, int& cols, std::vector<float>& field)
+{
+	cv::Mat grayImage;
+	float sign;
+	if (!readTraceImage(imagePath, grayImage, sign)) {
+		return false;
+	}
+	rows = grayImage.rows;
+	cols = grayImage.cols;
+	std::vector<Eigen::Vector2f> contour;
+	traceBoundary([&](int y, int x) {
+		return sign * (grayImage.at<uchar>(y, x) - TRACE_THRESHOLD);
+	}, rows, cols, sign > 0.0f ? -TRACE_THRESHOLD : TRACE_THRESHOLD - 255.0f, contour);
+	if (!signedDistanceField(contour, rows, cols, field)) {
+		std::cerr << "No boundary found in " << imagePath << std::endl;
+		return false;
+	}
+	return true;
+}
+
+#endif
@@ -0,0 +1,139 @@
+#ifndef __FRAME_CACHE_HPP__
+#define __FRAME_CACHE_HPP__
+
+#define SEQUENCE_FRAMES 101
+#define FRAME_CACHE_SIZE 268435456
+#define PREFETCH_RADIUS 3
+#include "../algorithm/InterpolationWorker.hpp"
+#include <cmath>
+#include <cstring>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// ģʽȨΪSEQUENCE_FRAMES֡key֡ȨΪkey / (SEQUENCE_FRAMES - 1)
+int sequenceKey(float weight) {
+	int key = static_cast<int>(std::lround(weight * (SEQUENCE_FRAMES - 1)));
+	return std::max(0, std::min(key, SEQUENCE_FRAMES - 1));
+}
+
+float sequenceWeight(int key) {
+	return static_cast<float>(key) / (SEQUENCE_FRAMES - 1);
+}
+
+// еһֻ֡ʵʹõĶ
+struct CachedFrame {
+	std::vector<float> pointCenters;
+	std::vector<float> edgePointVertices;
+	std::vector<Eigen::Vector3f> hull;
+
+	CachedFrame(const FrameData& frame)
+		: pointCenters(frame.pointCenters.data(), frame.pointCenters.data() + frame.pointCenterSize / sizeof(float)),
+		edgePointVertices(frame.edgePointVertices.data(), frame.edgePointVertices.data() + frame.edgePointSize / sizeof(float)),
+		hull(frame.hull) {
+	}
+
+	size_t bytes() const {
+		return (pointCenters.size() + edgePointVertices.size()) * sizeof(float) + hull.size() * sizeof(Eigen::Vector3f);
+	}
+
+	// ֡ڴ泬Ԥʱfalse
+	bool copyTo(FrameData& frame) const {
+		frame.pointCenterSize = pointCenters.size() * sizeof(float);
+		frame.edgePointSize = edgePointVertices.size() * sizeof(float);
+		if (!frame.pointCenters.reserve(frame.pointCenterSize) || !frame.edgePointVertices.reserve(frame.edgePointSize)) {
+			return false;
+		}
+		memcpy(frame.pointCenters.data(), pointCenters.data(), frame.pointCenterSize);
+		memcpy(frame.edgePointVertices.data(), edgePointVertices.data(), frame.edgePointSize);
+		frame.hull = hull;
+		return true;
+	}
+};
+
+// ̰߳ȫLRU֡棬ܴСmaxBytesʱ̭δʹõ֡
+class FrameCache {
+public:
+	FrameCache(size_t maxBytes) : maxBytes(maxBytes) {
+	}
+
+	std::shared_ptr<const CachedFrame> get(int key) {
+		std::lock_guard<std::mutex> lock(mutex);
+		auto it = frames.find(key);
+		if (it == frames.end()) {
+			misses++;
+			return nullptr;
+		}
+		hits++;
+		order.splice(order.begin(), order, it->second.second);
+		return it->second.first;
+	}
+
+	bool contains(int key) {
+		std::lock_guard<std::mutex> lock(mutex);
+		return frames.count(key) > 0;
+	}
+
+	void put(int key, std::shared_ptr<const CachedFrame> frame) {
+		std::lock_guard<std::mutex> lock(mutex);
+		auto it = frames.find(key);
+		if (it != frames.end()) {
+			totalBytes -= it->second.first->bytes();
+			order.erase(it->second.second);
+			frames.erase(it);
+		}
+		totalBytes += frame->bytes();
+		order.push_front(key);
+		frames.emplace(key, std::make_pair(std::move(frame), order.begin()));
+		while (totalBytes > maxBytes && order.size() > 1) {
+			auto last = frames.find(order.back());
+			totalBytes -= last->second.first->bytes();
+			frames.erase(last);
+			order.pop_back();
+			evictions++;
+		}
+	}
+
+	void clear() {
+		std::lock_guard<std::mutex> lock(mutex);
+		frames.clear();
+		order.clear();
+		totalBytes = 0;
+	}
+
+	int count() {
+		std::lock_guard<std::mutex> lock(mutex);
+		return frames.size();
+	}
+
+	size_t size() {
+		std::lock_guard<std::mutex> lock(mutex);
+		return totalBytes;
+	}
+
+	int getHits() const {
+		return hits;
+	}
+
+	int getMisses() const {
+		return misses;
+	}
+
+	int getEvictions() const {
+		return evictions;
+	}
+
+private:
+	size_t maxBytes;
+	size_t totalBytes = 0;
+	std::list<int> order;
+	std::unordered_map<int, std::pair<std::shared_ptr<const CachedFrame>, std::list<int>::iterator>> frames;
+	std::mutex mutex;
+	std::atomic<int> hits{ 0 };
+	std::atomic<int> misses{ 0 };
+	std::atomic<int> evictions{ 0 };
+};
+
+#endif
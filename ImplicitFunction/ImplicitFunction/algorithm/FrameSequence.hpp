@@ -0,0 +1,190 @@
+#ifndef __FRAME_SEQUENCE_HPP__
+#define __FRAME_SEQUENCE_HPP__
+
+#define SEQUENCE_REUSE_TOLERANCE 0.25f
+#define SEQUENCE_REFINE_ITERATIONS 8
+#define SEQUENCE_REFINE_TOLERANCE 1e-3
+#define SEQUENCE_STRIDE 1
+#include "../algorithm/ImplicitFunction.hpp"
+#include "../algorithm/ImageProcess.hpp"
+#include "../algorithm/LinearSystem.hpp"
+#include <Eigen/Dense>
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+struct SequenceStatistics {
+	int frames = 0;
+	// ߽ƶSEQUENCE_REUSE_TOLERANCEֱһ֡Լϵ֡
+	int reused = 0;
+	// һ֡ϵΪֵþɵķֽĽ֡Լܴ
+	int warmStarts = 0;
+	int iterations = 0;
+	// LUֽ֡
+	int coldSolves = 0;
+	// Ľ֡·ֽ֡ʱ䣬·ֽ֮֡ǰδĵ
+	double warmMilliseconds = 0.0;
+	double coldMilliseconds = 0.0;
+};
+
+// ʹպϱ߽ķΪpreAreaı߽һ£Ҫʱתıareaķţanchorĵתͷ
+void alignContour(std::vector<Eigen::Vector2f>& contour, float& area, float preArea, const Eigen::Vector2f& anchor) {
+	if ((area > 0.0f) != (preArea > 0.0f)) {
+		std::reverse(contour.begin(), contour.end());
+		area = -area;
+	}
+	size_t nearest = 0;
+	float minDistance = FLT_MAX;
+	for (size_t i = 0; i < contour.size(); i++) {
+		float distance = (contour[i] - anchor).squaredNorm();
+		if (distance < minDistance) {
+			minDistance = distance;
+			nearest = i;
+		}
+	}
+	std::rotate(contour.begin(), contour.begin() + nearest, contour.end());
+}
+
+// ֡ƵͼƬУÿ֡ڻҶһmarching squaresõر߽磬֡ٱ߽磬
+// ʹ֡ԼһһӦ߽ķһ֡һ£ȡһ֡һ߽Լĵ
+// һ֡contourConstraintPoints()ȡԼ㲢ڱ߽ϵλã֮ÿ֡Щλȡ㣬
+// Լͷֲв
+// Լ㼸ʱһ֡һ֡ϵΪֵһLUֽĽ
+// ÿֻ֡O(n^2)ʱ·ֽ
+class FrameSequence {
+public:
+	// һ֡õ֡֡Ҳ߽Լʱfalse
+	bool next(const cv::Mat& frame, ImplicitFunctionModel& model) {
+		cv::Mat grayImage;
+		if (frame.channels() == 1) {
+			grayImage = frame;
+		}
+		else {
+			cv::cvtColor(frame, grayImage, frame.channels() == 4 ? cv::COLOR_BGRA2GRAY : cv::COLOR_BGR2GRAY);
+		}
+		// ֻɵһ֡ǰ߿ʱ֡䷭ת
+		if (sign == 0.0f) {
+			sign = backgroundSign(grayImage);
+		}
+		std::vector<Eigen::Vector2f> contour;
+		float area = traceBoundary([&](int y, int x) {
+			return sign * (grayImage.at<uchar>(y, x) - TRACE_THRESHOLD);
+		}, grayImage.rows, grayImage.cols, sign > 0.0f ? -TRACE_THRESHOLD : TRACE_THRESHOLD - 255.0f, contour);
+		if (contour.size() < 3) {
+			std::cerr << "No boundary found in frame " << statistics.frames << std::endl;
+			return false;
+		}
+		statistics.frames++;
+		track(contour, area);
+
+		std::vector<Eigen::Vector2f> boundaryPoints, normalPoints;
+		if (samplePositions.empty()) {
+			contourConstraintPoints(contour, area, boundaryPoints, normalPoints);
+			closedPolylinePositions(boundaryPoints, samplePositions);
+		}
+		else {
+			sampleClosedPolyline(contour, samplePositions, boundaryPoints);
+			boundaryNormalPoints(boundaryPoints, area, normalPoints);
+		}
+		model.rows = grayImage.rows;
+		model.cols = grayImage.cols;
+		model.constraints.clear();
+		for (const auto& point : boundaryPoints) {
+			model.constraints.emplace_back(Eigen::Vector3f(point.x(), point.y(), 0.0f), 0.0f);
+		}
+		for (const auto& point : normalPoints) {
+			model.constraints.emplace_back(Eigen::Vector3f(point.x(), point.y(), 0.0f), 1.0f);
+		}
+		preArea = area;
+
+		if (unchanged(model.constraints)) {
+			statistics.reused++;
+			model = previous;
+			return true;
+		}
+		if (!solve(model)) {
+			return false;
+		}
+		previous = model;
+		return true;
+	}
+
+	const SequenceStatistics& getStatistics() const {
+		return statistics;
+	}
+
+private:
+	float sign = 0.0f;
+	float preArea = 0.0f;
+	ImplicitFunctionModel previous;
+	// һ֡ı߽Լڱ߽ϵλ
+	std::vector<float> samplePositions;
+	// һֽľһ֡Ľ
+	LUFactorization<float> factorization;
+	std::vector<float> X;
+	SequenceStatistics statistics;
+
+	// ʹ߽һ֡Ӧһ£ȡһ֡һ߽Լĵ
+	void track(std::vector<Eigen::Vector2f>& contour, float& area) const {
+		if (!previous.constraints.empty()) {
+			alignContour(contour, area, preArea, previous.constraints[0].first.head<2>());
+		}
+	}
+
+	// Լһ֡Ӧľ붼SEQUENCE_REUSE_TOLERANCE
+	bool unchanged(const std::vector<std::pair<Eigen::Vector3f, float>>& constraints) const {
+		if (constraints.size() != previous.constraints.size()) {
+			return false;
+		}
+		for (size_t i = 0; i < constraints.size(); i++) {
+			if ((constraints[i].first - previous.constraints[i].first).norm() > SEQUENCE_REUSE_TOLERANCE) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool solve(ImplicitFunctionModel& model) {
+		int numConstraints = model.constraints.size();
+		int n = numConstraints + DIMENSION + 1;
+		if (n > MAX_MATRIX_DIMENSION) {
+			std::cerr << "Too many constraints!" << std::endl;
+			return false;
+		}
+		Eigen::MatrixXf A;
+		Eigen::VectorXf B;
+		implicitSystem(model.constraints, A, B);
+		std::vector<float> rowMajorA(n * n), vectorB(B.data(), B.data() + n);
+		Eigen::Map<Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>(rowMajorA.data(), n, n) = A;
+
+		auto start = std::chrono::steady_clock::now();
+		int iterations = 0;
+		bool converged = false;
+		if (factorization.n == n && X.size() == n) {
+			converged = refine(rowMajorA, vectorB, factorization, X, SEQUENCE_REFINE_ITERATIONS, SEQUENCE_REFINE_TOLERANCE, iterations);
+			statistics.iterations += iterations;
+		}
+		if (converged) {
+			statistics.warmStarts++;
+		}
+		else {
+			lu(rowMajorA, factorization, n);
+			::solve(factorization, vectorB, X);
+			statistics.coldSolves++;
+		}
+		double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		(converged ? statistics.warmMilliseconds : statistics.coldMilliseconds) += milliseconds;
+
+		Eigen::Map<Eigen::VectorXf> vectorX(X.data(), n);
+		model.weights = vectorX.head(numConstraints);
+		model.P0 = vectorX(numConstraints);
+		model.P = vectorX.tail(DIMENSION);
+		checkConstraints(model.constraints, model.weights, model.P0, model.P);
+		return true;
+	}
+};
+
+#endif
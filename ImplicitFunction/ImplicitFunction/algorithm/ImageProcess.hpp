@@ -8,12 +8,17 @@
 #define APERTURE_SIZE 3
 #define SAMPLE_NUM 50
 #define OFFSET 2.0
+#define TRACE_THRESHOLD 127.5f
+#define BOUNDARY_TOLERANCE 1.0f
+#define PYRAMID_SPACING 4.0f
 #include "../algorithm/PointProcess.hpp"
 #include "../algorithm/ImplicitFunction.hpp"
+#include "../algorithm/MarchingSquares.hpp"
 #include <opencv2/opencv.hpp>
 #include <opencv2/highgui/highgui.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
 #include <opencv2/core/utils/logger.hpp>
+#include <functional>
 
 // cv::PointתΪEigen::Vector2f
 void convertPoints(const std::vector<cv::Point>& cvPoints, std::vector<Eigen::Vector2f>& eigenPoints) {
@@ -53,36 +58,165 @@ void normalWithWeights(const cv::Point& pre, const cv::Point& cur, const cv::Poi
 	}
 }
 
-// ݱ߽ԼԼ
+// ݱ߽ԼԼ㣺طOFFSETΪңֱǡһѡڲȡڲǸ
+// ȰΪ벢һξ任õзž루ڲΪΪ0ÿжֻ㲢м
 void normalPointCalc(const std::vector<cv::Point>& boundaryPoints, std::vector<cv::Point>& normalPoints) {
 	int n = boundaryPoints.size();
+	if (n == 0) {
+		return;
+	}
+	// 븲İΧвһȦⲿϵزڲpointPolygonTest(..., false) > 0һ
+	cv::Rect rect = cv::boundingRect(boundaryPoints);
+	cv::Point origin(rect.x - 1, rect.y - 1);
+	cv::Mat mask = cv::Mat::zeros(rect.height + 2, rect.width + 2, CV_8UC1);
+	std::vector<std::vector<cv::Point>> polygons(1);
+	for (const auto& point : boundaryPoints) {
+		polygons[0].emplace_back(point - origin);
+	}
+	cv::fillPoly(mask, polygons, cv::Scalar(255));
+	cv::polylines(mask, polygons, true, cv::Scalar(0));
+	cv::Mat insideDistance, outsideDistance, signedDistance;
+	cv::distanceTransform(mask, insideDistance, cv::DIST_L2, cv::DIST_MASK_PRECISE);
+	cv::distanceTransform(255 - mask, outsideDistance, cv::DIST_L2, cv::DIST_MASK_PRECISE);
+	signedDistance = insideDistance - outsideDistance;
+	auto distanceAt = [&](const cv::Point& point) {
+		int x = point.x - origin.x, y = point.y - origin.y;
+		if (x < 0 || y < 0 || x >= signedDistance.cols || y >= signedDistance.rows) {
+			return -1.0f;
+		}
+		return signedDistance.at<float>(y, x);
+	};
+	// ѡ㶼뿪Χк󲻿еڲ
+	int maxSteps = static_cast<int>(std::max(rect.width, rect.height) / OFFSET) + 2;
+
 	auto previousIndex = [=](int i) { return (i - 1 + n) % n; };
 	auto postIndex = [=](int i) { return (i + 1) % n; };
-	cv::Point candidiates[2];
-	double candidateInsideContour[2];
+	size_t base = normalPoints.size();
+	normalPoints.resize(base + n);
+#pragma omp parallel for
 	for (int i = 0; i < n; i++) {
 		cv::Point cur = boundaryPoints[i];
 		cv::Point prev = boundaryPoints[previousIndex(i)];
 		cv::Point post = boundaryPoints[postIndex(i)];
 		cv::Vec2f normal;
 		normalWithoutWeights(prev, cur, post, normal);
+		cv::Point candidiates[2];
+		float candidateDistance[2];
 		bool findNormalPoint = false;
-		int cnt = 1;
-		while (!findNormalPoint) {
+		for (int cnt = 1; cnt <= maxSteps && !findNormalPoint; cnt++) {
 			candidiates[0] = cv::Point(cur.x + normal[0] * OFFSET * cnt, cur.y + normal[1] * OFFSET * cnt);
 			candidiates[1] = cv::Point(cur.x - normal[0] * OFFSET * cnt, cur.y - normal[1] * OFFSET * cnt);
-			candidateInsideContour[0] = pointPolygonTest(boundaryPoints, candidiates[0], false);
-			candidateInsideContour[1] = pointPolygonTest(boundaryPoints, candidiates[1], false);
-			findNormalPoint = (candidateInsideContour[0] > 0) ^ (candidateInsideContour[1] > 0);
-			cnt++;
+			candidateDistance[0] = distanceAt(candidiates[0]);
+			candidateDistance[1] = distanceAt(candidiates[1]);
+			findNormalPoint = (candidateDistance[0] > 0) ^ (candidateDistance[1] > 0);
 		}
-		if (candidateInsideContour[0] > 0) {
-			normalPoints.emplace_back(candidiates[0]);
+		if (!findNormalPoint) {
+			// ˻ϸĲ֣ȡһзžϴһ
+			candidiates[0] = cv::Point(cur.x + normal[0] * OFFSET, cur.y + normal[1] * OFFSET);
+			candidiates[1] = cv::Point(cur.x - normal[0] * OFFSET, cur.y - normal[1] * OFFSET);
+			candidateDistance[0] = distanceAt(candidiates[0]);
+			candidateDistance[1] = distanceAt(candidiates[1]);
 		}
-		else {
-			normalPoints.emplace_back(candidiates[1]);
+		normalPoints[base + i] = candidateDistance[0] > candidateDistance[1] ? candidiates[0] : candidiates[1];
+	}
+}
+
+// 㵽߶abľ
+float segmentDistance(const Eigen::Vector2f& point, const Eigen::Vector2f& a, const Eigen::Vector2f& b) {
+	Eigen::Vector2f ab = b - a;
+	float length = ab.squaredNorm();
+	float t = length > 0.0f ? std::max(0.0f, std::min(1.0f, (point - a).dot(ab) / length)) : 0.0f;
+	return (a + t * ab - point).norm();
+}
+
+// պDouglas-Peuckerֽ⣬ֻһΣõݲµĲ㣺ȡԶĵ㣨͹ϣͨǼǣ
+// һ˵ȡԶĵ㣻ÿȡҾĵ㣬Ϊõsignificanceٵݹֳ
+// ҵsignificance븸ڵȡСֵʹصݹ鵥ݲΪtoleranceʱĲǡsignificance > toleranceĵ
+// ˵significanceΪFLT_MAXʽջݹ飬ÿܹO(n)ͨΪO(n log n)
+void contourSignificance(const std::vector<Eigen::Vector2f>& contour, std::vector<float>& significance, int& start) {
+	int n = contour.size();
+	Eigen::Vector2f center = Eigen::Vector2f::Zero();
+	for (const auto& point : contour) {
+		center += point;
+	}
+	center /= n;
+	start = 0;
+	for (int i = 1; i < n; i++) {
+		if ((contour[i] - center).squaredNorm() > (contour[start] - center).squaredNorm()) {
+			start = i;
+		}
+	}
+	int opposite = start;
+	for (int i = 0; i < n; i++) {
+		if ((contour[i] - contour[start]).squaredNorm() > (contour[opposite] - contour[start]).squaredNorm()) {
+			opposite = i;
+		}
+	}
+	significance.assign(n, 0.0f);
+	significance[start] = FLT_MAX;
+	significance[opposite] = FLT_MAX;
+	// ҵչ±[start, start + n]еλú͸ڵsignificance
+	struct Chord {
+		int from, to;
+		float limit;
+	};
+	int middle = opposite > start ? opposite : opposite + n;
+	std::vector<Chord> stack = { { start, middle, FLT_MAX }, { middle, start + n, FLT_MAX } };
+	while (!stack.empty()) {
+		Chord chord = stack.back();
+		stack.pop_back();
+		if (chord.to - chord.from < 2) {
+			continue;
+		}
+		const Eigen::Vector2f& a = contour[chord.from % n];
+		const Eigen::Vector2f& b = contour[chord.to % n];
+		int farthest = chord.from + 1;
+		float maxDistance = -1.0f;
+		for (int k = chord.from + 1; k < chord.to; k++) {
+			float distance = segmentDistance(contour[k % n], a, b);
+			if (distance > maxDistance) {
+				maxDistance = distance;
+				farthest = k;
+			}
+		}
+		float value = std::min(maxDistance, chord.limit);
+		significance[farthest % n] = value;
+		stack.push_back({ chord.from, farthest, value });
+		stack.push_back({ farthest, chord.to, value });
+	}
+}
+
+// Ӧزպڱ߽toleranceǰþٵĵ㣬ܡƽֱ
+// maxNumԼ̵ĹģޣʱŴݲsignificanceݲĵ
+// ֱȡmaxNum + 1significanceΪݲҪ
+void adaptiveSampleIndexes(const std::vector<Eigen::Vector2f>& contour, float tolerance, int maxNum, std::vector<int>& indexes) {
+	indexes.clear();
+	int n = contour.size();
+	if (n < 3) {
+		for (int i = 0; i < n; i++) {
+			indexes.push_back(i);
+		}
+		return;
+	}
+	int start;
+	std::vector<float> significance;
+	contourSignificance(contour, significance, start);
+	int count = std::count_if(significance.begin(), significance.end(), [&](float value) {
+		return value > tolerance;
+	});
+	if (count > maxNum) {
+		std::vector<float> sorted = significance;
+		std::nth_element(sorted.begin(), sorted.begin() + maxNum, sorted.end(), std::greater<float>());
+		tolerance = sorted[maxNum];
+	}
+	for (int i = start; i < start + n; i++) {
+		if (significance[i % n] > tolerance) {
+			indexes.push_back(i % n);
 		}
 	}
+	if (count > maxNum) {
+		std::cout << "Boundary tolerance raised to " << tolerance << " to keep " << indexes.size() << " constraint points" << std::endl;
+	}
 }
 
 // ͼ1opencvȡƽֱõ߽ԼͷԼ
@@ -275,6 +409,16 @@ void processImage3(
 #endif // IMAGE_DEBUG
 
 	std::vector<cv::Point> externalContourProx, internalContourProx;
+#ifdef RESAMPLE_MODE
+	// ÿ߽Լ㻹ӦһԼ㣬ϵάΪ2DIMENSION + 1
+	std::vector<Eigen::Vector2f> contourPoints;
+	std::vector<int> sampleIndexes;
+	convertPoints(externalContour, contourPoints);
+	adaptiveSampleIndexes(contourPoints, BOUNDARY_TOLERANCE, (MAX_MATRIX_DIMENSION - DIMENSION - 1) / 2, sampleIndexes);
+	for (int index : sampleIndexes) {
+		externalContourProx.emplace_back(externalContour[index]);
+	}
+#else
 	double contourLength = cv::arcLength(externalContour, true);
 	double segmentLength = contourLength / SAMPLE_NUM;
 	int contourPointsNum = externalContour.size();
@@ -293,6 +437,7 @@ void processImage3(
 		}
 		preLength = curLength;
 	}
+#endif // RESAMPLE_MODE
 
 #ifdef IMAGE_DEBUG
 	cv::Mat externalContourProxImage = cv::Mat::zeros(srcImage.size(), CV_8UC3);
@@ -331,12 +476,330 @@ void processImage3(
 	convertPoints(internalContourProx, normalPoints);
 }
 
-// ͼ4Լı߽㷨õ߽Լ㣬ݱ߽Լ㷨Լ
-void processImage4(const char* imagePath,
+// պߵ0ʱڲǰߣorientation()µʱ룩
+float signedArea(const std::vector<Eigen::Vector2f>& polyline) {
+	double area = 0.0;
+	int n = polyline.size();
+	for (int i = 0; i < n; i++) {
+		const Eigen::Vector2f& p = polyline[i];
+		const Eigen::Vector2f& q = polyline[(i + 1) % n];
+		area += static_cast<double>(p.x()) * q.y() - static_cast<double>(q.x()) * p.y();
+	}
+	return static_cast<float>(area * 0.5);
+}
+
+// ڱպϰλȡ㣺positionsΪӵһĻռܳı[0, 1)
+// Բֵؾ
+void sampleClosedPolyline(const std::vector<Eigen::Vector2f>& polyline, const std::vector<float>& positions, std::vector<Eigen::Vector2f>& result) {
+	int n = polyline.size();
+	std::vector<float> lengths(n + 1, 0.0f);
+	for (int i = 0; i < n; i++) {
+		lengths[i + 1] = lengths[i] + (polyline[(i + 1) % n] - polyline[i]).norm();
+	}
+	int k = 0;
+	for (float position : positions) {
+		float target = lengths[n] * position;
+		while (k + 1 < n && lengths[k + 1] <= target) {
+			k++;
+		}
+		float length = lengths[k + 1] - lengths[k];
+		float t = length > 0.0f ? (target - lengths[k]) / length : 0.0f;
+		result.emplace_back(polyline[k] + t * (polyline[(k + 1) % n] - polyline[k]));
+	}
+}
+
+// ѱպ߾ȵ²Ϊnum
+void resampleClosedPolyline(const std::vector<Eigen::Vector2f>& polyline, int num, std::vector<Eigen::Vector2f>& result) {
+	std::vector<float> positions(num);
+	for (int s = 0; s < num; s++) {
+		positions[s] = static_cast<float>(s) / num;
+	}
+	sampleClosedPolyline(polyline, positions, result);
+}
+
+// պϵĵλãӵһߵĻռܳı[0, 1)
+void closedPolylinePositions(const std::vector<Eigen::Vector2f>& polyline, std::vector<float>& positions) {
+	int n = polyline.size();
+	positions.assign(n, 0.0f);
+	float length = 0.0f;
+	for (int i = 0; i < n; i++) {
+		positions[i] = length;
+		length += (polyline[(i + 1) % n] - polyline[i]).norm();
+	}
+	for (auto& position : positions) {
+		position = length > 0.0f ? position / length : 0.0f;
+	}
+}
+
+// rows  colsͼƬһmarching squarespixel(y, x)صֵڲΪ
+// 油һȦֵΪbackgroundӦСڵ0أʹߵ״Ҳõպϵı߽
+// ıպϱ߽簴˳contour꣩ûбպϱ߽ʱ0
+template <typename F> float traceBoundary(F&& pixel, int rows, int cols, float background, std::vector<Eigen::Vector2f>& contour)
+{
+	// (i, j)Ӧ(y, x) = (i - 1, j - 1)ĵһάȡУɨʱأõĵٽ
+	auto value = [&](int i, int j) {
+		int y = i - 1, x = j - 1;
+		if (y < 0 || y >= rows || x < 0 || x >= cols) {
+			return background;
+		}
+		return pixel(y, x);
+	};
+	std::vector<MarchingSegment> segments;
+	marchingSquaresCells(value, cols + 2, 1.0f, 0, rows + 1, 0, cols + 1, segments);
+	std::vector<Polyline> polylines;
+	chainSegments(segments, polylines);
+
+	std::vector<Eigen::Vector2f> candidate;
+	float maxArea = 0.0f;
+	contour.clear();
+	for (const auto& polyline : polylines) {
+		if (!polyline.closed) {
+			continue;
+		}
+		candidate.clear();
+		for (const auto& point : polyline.points) {
+			candidate.emplace_back(point[1] - 1.0f, point[0] - 1.0f);
+		}
+		float area = signedArea(candidate);
+		if (fabs(area) > fabs(maxArea)) {
+			maxArea = area;
+			contour.swap(candidate);
+		}
+	}
+	return maxArea;
+}
+
+// Ҷͼ״ڲķţͼƬ߿ƽֵTRACE_THRESHOLDʱΪɫ״Ϊɫ-1򷵻1
+float backgroundSign(const cv::Mat& grayImage) {
+	int rows = grayImage.rows, cols = grayImage.cols;
+	double border = 0.0;
+	for (int x = 0; x < cols; x++) {
+		border += grayImage.at<uchar>(0, x) + grayImage.at<uchar>(rows - 1, x);
+	}
+	for (int y = 0; y < rows; y++) {
+		border += grayImage.at<uchar>(y, 0) + grayImage.at<uchar>(y, cols - 1);
+	}
+	return border / (2.0 * (rows + cols)) > TRACE_THRESHOLD ? -1.0f : 1.0f;
+}
+
+// ɱպϱ߽ϵԼõԼ㣺ȡǰ֮ڲΪߵ
+void boundaryNormalPoints(const std::vector<Eigen::Vector2f>& boundaryPoints, float area, std::vector<Eigen::Vector2f>& normalPoints)
+{
+	int n = boundaryPoints.size();
+	for (int i = 0; i < n; i++) {
+		Eigen::Vector2f tangent = boundaryPoints[(i + 1) % n] - boundaryPoints[(i - 1 + n) % n];
+		Eigen::Vector2f normal = Eigen::Vector2f(-tangent.y(), tangent.x()).normalized();
+		if (area < 0.0f) {
+			normal = -normal;
+		}
+		normalPoints.emplace_back(boundaryPoints[i] + normal * OFFSET);
+	}
+}
+
+// صıպϱ߽õ߽ԼͷԼ㣬areaΪ߽
+void contourConstraintPoints(
+	const std::vector<Eigen::Vector2f>& externalContour, float area,
+	std::vector<Eigen::Vector2f>& boundaryPoints,
+	std::vector<Eigen::Vector2f>& normalPoints)
+{
+#ifdef RESAMPLE_MODE
+	std::vector<int> sampleIndexes;
+	adaptiveSampleIndexes(externalContour, BOUNDARY_TOLERANCE, (MAX_MATRIX_DIMENSION - DIMENSION - 1) / 2, sampleIndexes);
+	for (int index : sampleIndexes) {
+		boundaryPoints.emplace_back(externalContour[index]);
+	}
+#else
+	resampleClosedPolyline(externalContour, SAMPLE_NUM, boundaryPoints);
+#endif // RESAMPLE_MODE
+	boundaryNormalPoints(boundaryPoints, area, normalPoints);
+}
+
+#ifdef IMAGE_DEBUG
+// ʾصı߽Լ㣨Լ㣨̣ߵߣ죩
+void showConstraintPoints(cv::Size size, const std::vector<Eigen::Vector2f>& boundaryPoints, const std::vector<Eigen::Vector2f>& normalPoints) {
+	cv::Mat constraintPointImage = cv::Mat::zeros(size, CV_8UC3);
+	for (int i = 0; i < boundaryPoints.size(); i++) {
+		cv::Point2f boundary(boundaryPoints[i].x(), boundaryPoints[i].y());
+		cv::Point2f normal(normalPoints[i].x(), normalPoints[i].y());
+		cv::circle(constraintPointImage, boundary, 0.5, cv::Scalar(255, 0, 0), 4);
+		cv::circle(constraintPointImage, normal, 0.5, cv::Scalar(0, 255, 0), 4);
+		cv::line(constraintPointImage, boundary, normal, cv::Scalar(0, 0, 255), 1);
+	}
+	cv::imshow("constraint_point_image", constraintPointImage);
+	cv::waitKey(0);
+}
+#endif // IMAGE_DEBUG
+
+// ȡȡ߽õ8λͨͼƬ͸alphaͨTRACE_THRESHOLDʱȡalphaͨsignΪ1
+// ȡҶȣsignbackgroundSign()sign * (ֵ - TRACE_THRESHOLD)״ڲΪ
+bool readTraceImage(const char* imagePath, cv::Mat& grayImage, float& sign)
+{
+	cv::Mat srcImage = cv::imread(imagePath, cv::IMREAD_UNCHANGED);
+	if (srcImage.empty()) {
+		std::cerr << "Failed to read " << imagePath << std::endl;
+		return false;
+	}
+	if (srcImage.depth() == CV_16U) {
+		srcImage.convertTo(srcImage, CV_8U, 1.0 / 257.0);
+	}
+	else if (srcImage.depth() != CV_8U) {
+		std::cerr << "Unsupported image depth: " << imagePath << std::endl;
+		return false;
+	}
+
+	// ״ڲֵΪalphaͨ͸ĲΪڲҶͼıͼƬ߿ƽֵ
+	sign = 1.0f;
+	bool useAlpha = false;
+	if (srcImage.channels() == 4) {
+		cv::extractChannel(srcImage, grayImage, 3);
+		double minAlpha, maxAlpha;
+		cv::minMaxLoc(grayImage, &minAlpha, &maxAlpha);
+		useAlpha = minAlpha < TRACE_THRESHOLD && maxAlpha > TRACE_THRESHOLD;
+	}
+	if (!useAlpha) {
+		if (srcImage.channels() == 1) {
+			grayImage = srcImage;
+		}
+		else {
+			cv::cvtColor(srcImage, grayImage, srcImage.channels() == 4 ? cv::COLOR_BGRA2GRAY : cv::COLOR_BGR2GRAY);
+		}
+		sign = backgroundSign(grayImage);
+	}
+	return true;
+}
+
+// ͼ4ڻҶȣ͸ʱalphaͨһmarching squaresõص߽磬
+// ȡıպϱ߽簴SAMPLE_NUM߽Լ㣬ԼطƫOFFSET
+// ҪCannyfindContoursҲԵõظı߽
+// ͼƬ޷ȡûбպϱ߽ʱfalse
+bool processImage4(
+	const char* imagePath,
+	int& rows, int& cols,
+	std::vector<Eigen::Vector2f>& boundaryPoints,
+	std::vector<Eigen::Vector2f>& normalPoints)
+{
+	cv::Mat grayImage;
+	float sign;
+	if (!readTraceImage(imagePath, grayImage, sign)) {
+		return false;
+	}
+	rows = grayImage.rows;
+	cols = grayImage.cols;
+#ifdef IMAGE_DEBUG
+	cv::imshow("gray_image", grayImage);
+	cv::waitKey(0);
+#endif // IMAGE_DEBUG
+
+	float background = sign > 0.0f ? -TRACE_THRESHOLD : TRACE_THRESHOLD - 255.0f;
+	std::vector<Eigen::Vector2f> externalContour;
+	float maxArea = traceBoundary([&](int y, int x) {
+		return sign * (grayImage.at<uchar>(y, x) - TRACE_THRESHOLD);
+	}, rows, cols, background, externalContour);
+	if (externalContour.size() < 3) {
+		std::cerr << "No boundary found in " << imagePath << std::endl;
+		return false;
+	}
+
+	contourConstraintPoints(externalContour, maxArea, boundaryPoints, normalPoints);
+
+#ifdef IMAGE_DEBUG
+	showConstraintPoints(grayImage.size(), boundaryPoints, normalPoints);
+#endif // IMAGE_DEBUG
+	return true;
+}
+
+// ͼ5ܴͼƬԭֱֻһλҶͼcv::pyrDown()С1/8ֵһ㿪ʼȡ߽磬
+// ߽㹻ܰPYRAMID_SPACINGļвʱһı߽ȷǰİΧУ
+// ֻԭֱʵİΧmarching squaresõر߽磬ٶŲɫͼƬCannyfindContours
+// ԭֱʵĻҶͼҪ룬IMREAD_REDUCED_GRAYSCALE_*СͼƬJPEGĸʽС
+// JPEGҲظļؽ룬ѽĻҶͼpyrDown()
+// ͼƬ޷ȡûбպϱ߽ʱfalse
+bool processImage5(
+	const char* imagePath,
+	int& rows, int& cols,
 	std::vector<Eigen::Vector2f>& boundaryPoints,
 	std::vector<Eigen::Vector2f>& normalPoints)
 {
+#ifdef RESAMPLE_MODE
+	int sampleNum = (MAX_MATRIX_DIMENSION - DIMENSION - 1) / 2;
+#else
+	int sampleNum = SAMPLE_NUM;
+#endif // RESAMPLE_MODE
+	cv::Mat grayImage = cv::imread(imagePath, cv::IMREAD_GRAYSCALE);
+	if (grayImage.empty()) {
+		std::cerr << "Failed to read " << imagePath << std::endl;
+		return false;
+	}
+	rows = grayImage.rows;
+	cols = grayImage.cols;
+	float sign = backgroundSign(grayImage);
+
+	// pyramid[k]ΪС1/2^(k+1)ͼƬ̫СĲ㲻
+	std::vector<cv::Mat> pyramid;
+	for (const cv::Mat* image = &grayImage; pyramid.size() < 3 && image->rows >= 16 && image->cols >= 16; image = &pyramid.back()) {
+		cv::Mat reducedImage;
+		cv::pyrDown(*image, reducedImage);
+		pyramid.push_back(reducedImage);
+	}
 
+	cv::Rect roi(0, 0, cols, rows);
+	for (int level = pyramid.size() - 1; level >= 0; level--) {
+		const cv::Mat& reducedImage = pyramid[level];
+		std::vector<Eigen::Vector2f> contour;
+		traceBoundary([&](int y, int x) {
+			return sign * (reducedImage.at<uchar>(y, x) - TRACE_THRESHOLD);
+		}, reducedImage.rows, reducedImage.cols, sign > 0.0f ? -TRACE_THRESHOLD : TRACE_THRESHOLD - 255.0f, contour);
+		float length = 0.0f;
+		for (int i = 0; i < contour.size(); i++) {
+			length += (contour[(i + 1) % contour.size()] - contour[i]).norm();
+		}
+		if (contour.size() < 3 || length < sampleNum * PYRAMID_SPACING) {
+			continue;
+		}
+		Eigen::Vector4f reducedBounds(FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX);
+		for (const auto& point : contour) {
+			reducedBounds = Eigen::Vector4f(std::min(reducedBounds[0], point.x()), std::min(reducedBounds[1], point.y()),
+				std::max(reducedBounds[2], point.x()), std::max(reducedBounds[3], point.y()));
+		}
+		// Χл㵽ԭֱʣС
+		float scaleX = static_cast<float>(cols) / reducedImage.cols, scaleY = static_cast<float>(rows) / reducedImage.rows;
+		int x0 = static_cast<int>(std::floor((reducedBounds[0] - 2.0f) * scaleX));
+		int y0 = static_cast<int>(std::floor((reducedBounds[1] - 2.0f) * scaleY));
+		int x1 = static_cast<int>(std::ceil((reducedBounds[2] + 3.0f) * scaleX));
+		int y1 = static_cast<int>(std::ceil((reducedBounds[3] + 3.0f) * scaleY));
+		roi &= cv::Rect(x0, y0, x1 - x0, y1 - y0);
+		if (roi.empty()) {
+			roi = cv::Rect(0, 0, cols, rows);
+		}
+		break;
+	}
+	// СͼƬʹãͷ
+	pyramid.clear();
+	cv::Mat roiImage = grayImage(roi);
+
+#ifdef IMAGE_DEBUG
+	cv::imshow("roi_image", roiImage);
+	cv::waitKey(0);
+#endif // IMAGE_DEBUG
+
+	std::vector<Eigen::Vector2f> externalContour;
+	float maxArea = traceBoundary([&](int y, int x) {
+		return sign * (roiImage.at<uchar>(y, x) - TRACE_THRESHOLD);
+	}, roi.height, roi.width, sign > 0.0f ? -TRACE_THRESHOLD : TRACE_THRESHOLD - 255.0f, externalContour);
+	if (externalContour.size() < 3) {
+		std::cerr << "No boundary found in " << imagePath << std::endl;
+		return false;
+	}
+	for (auto& point : externalContour) {
+		point += Eigen::Vector2f(roi.x, roi.y);
+	}
+
+	contourConstraintPoints(externalContour, maxArea, boundaryPoints, normalPoints);
+
+#ifdef IMAGE_DEBUG
+	showConstraintPoints(grayImage.size(), boundaryPoints, normalPoints);
+#endif // IMAGE_DEBUG
+	return true;
 }
 
 #endif
\ No newline at end of file
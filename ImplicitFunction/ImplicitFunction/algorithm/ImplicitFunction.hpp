@@ -3,16 +3,26 @@
 
 #define STEP 2
 #define TOLERANCE 0.5f
+#define RBF_KERNEL "thin_plate"
+#define NEWTON_ITERATIONS 10
+#define NEWTON_TOLERANCE 1e-3f
+#define CONTOUR_STEP 8
 #include <Eigen/Dense>
 #include <Eigen/Core>
 #include <Eigen/LU>
 #include <Eigen/Eigen>
+#include "../algorithm/LinearSystem.hpp"
+#include "../algorithm/MarchingSquares.hpp"
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <assert.h>
 #include <vector>
 #include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <cmath>
 
 bool isZero(float x) {
     return fabs(x) < TOLERANCE;
@@ -27,6 +37,15 @@ float RBF(Eigen::Vector3f x) {
     return glm::pow(length, 2.0f) * glm::log(length);
 }
 
+// ݶȣgrad(r^2 * ln(r)) = x * (2 * ln(r) + 1)
+Eigen::Vector3f RBFGradient(const Eigen::Vector3f& x) {
+    float length = x.norm();
+    if (length == 0.0f) {
+        return Eigen::Vector3f::Zero();
+    }
+    return x * (2.0f * glm::log(length) + 1.0f);
+}
+
 // ڵxֵ
 float implicitFunctionValue(Eigen::Vector3f x,
     const std::vector<std::pair<Eigen::Vector3f, float>>& constraints,
@@ -42,6 +61,71 @@ float implicitFunctionValue(Eigen::Vector3f x,
     return res;
 }
 
+// һͼƬͼƬСԼԼõĶʽϵ͸Ȩ
+struct ImplicitFunctionModel {
+    int rows = 0;
+    int cols = 0;
+    std::vector<std::pair<Eigen::Vector3f, float>> constraints;
+    Eigen::VectorXf weights;
+    float P0 = 0.0f;
+    Eigen::Vector3f P = Eigen::Vector3f::Zero();
+};
+
+float implicitFunctionValue(const Eigen::Vector3f& x, const ImplicitFunctionModel& model) {
+    return implicitFunctionValue(x, model.constraints, model.weights, model.P0, model.P);
+}
+
+// w1 * f1 + w2 * f2 + ...һΪԼĲȨغͶʽϵԶӦȨ
+// ȨΪ0
+void combineImplicitFunctions(
+    const std::vector<float>& weights,
+    const std::vector<ImplicitFunctionModel>& models,
+    ImplicitFunctionModel& combined)
+{
+    combined.rows = models[0].rows;
+    combined.cols = models[0].cols;
+    combined.constraints.clear();
+    combined.P0 = 0.0f;
+    combined.P = Eigen::Vector3f::Zero();
+    int total = 0;
+    for (int k = 0; k < models.size(); k++) {
+        if (weights[k] != 0.0f) {
+            total += models[k].constraints.size();
+        }
+    }
+    combined.constraints.reserve(total);
+    combined.weights.resize(total);
+    int index = 0;
+    for (int k = 0; k < models.size(); k++) {
+        if (weights[k] == 0.0f) {
+            continue;
+        }
+        const auto& model = models[k];
+        combined.constraints.insert(combined.constraints.end(), model.constraints.begin(), model.constraints.end());
+        combined.weights.segment(index, model.weights.size()) = weights[k] * model.weights;
+        combined.P0 += weights[k] * model.P0;
+        combined.P += weights[k] * model.P;
+        index += model.weights.size();
+    }
+}
+
+// ڵxֵͽݶȣ߹õԼľ
+float implicitFunctionValueAndGradient(const Eigen::Vector3f& x, const ImplicitFunctionModel& model, Eigen::Vector3f& gradient) {
+    float res = model.P0 + x.dot(model.P);
+    gradient = model.P;
+    for (int i = 0; i < model.constraints.size(); i++) {
+        Eigen::Vector3f d = x - model.constraints[i].first;
+        float length = d.norm();
+        if (length == 0.0f) {
+            continue;
+        }
+        float logLength = glm::log(length);
+        res += model.weights(i) * length * length * logLength;
+        gradient += model.weights(i) * (2.0f * logLength + 1.0f) * d;
+    }
+    return res;
+}
+
 // Է󣬼ԼǷ
 void checkConstraints(
     const std::vector<std::pair<Eigen::Vector3f, float>>& constraints,
@@ -61,20 +145,15 @@ void checkConstraints(
     }
 }
 
-// Լδ֪ʽϵ͸Ȩ
-bool solveImplicitEquation(
+// ԼװԷA * X = BǰnumConstraintsΪԼ㴦ľֵͶʽDIMENSION + 1ԼȨʽ
+void implicitSystem(
     const std::vector<std::pair<Eigen::Vector3f, float>>& constraints,
-    Eigen::VectorXf& weights, float& P0, Eigen::Vector3f& P)
+    Eigen::MatrixXf& A, Eigen::VectorXf& B)
 {
     int numConstraints = constraints.size();
     int n = numConstraints + DIMENSION + 1;
-    if (n > MAX_MATRIX_DIMENSION) {
-        std::cout << "Too many constraints!" << std::endl;
-        return false;
-    }
-    Eigen::MatrixXf A = Eigen::MatrixXf::Zero(n, n);
-    Eigen::VectorXf B = Eigen::VectorXf::Zero(n);
-    Eigen::VectorXf X = Eigen::VectorXf::Zero(n);
+    A = Eigen::MatrixXf::Zero(n, n);
+    B = Eigen::VectorXf::Zero(n);
     for (int i = 0; i < numConstraints; i++) {
         for (int j = 0; j < numConstraints; j++) {
             A(i, j) = RBF(constraints[i].first - constraints[j].first);
@@ -92,16 +171,36 @@ bool solveImplicitEquation(
             A(numConstraints + j + 1, i) = constraints[i].first(j);
         }
     }
-    for (int i = 0; i < n; i++) {
-        if (i < numConstraints) {
-            B(i) = constraints[i].second;
-        }
-        else {
-            B(i) = 0.0f;
-        }
+    for (int i = 0; i < numConstraints; i++) {
+        B(i) = constraints[i].second;
     }
+}
 
+// Լδ֪ʽϵ͸Ȩ
+bool solveImplicitEquation(
+    const std::vector<std::pair<Eigen::Vector3f, float>>& constraints,
+    Eigen::VectorXf& weights, float& P0, Eigen::Vector3f& P)
+{
+    int numConstraints = constraints.size();
+    int n = numConstraints + DIMENSION + 1;
+    if (n > MAX_MATRIX_DIMENSION) {
+        std::cout << "Too many constraints!" << std::endl;
+        return false;
+    }
+    Eigen::MatrixXf A;
+    Eigen::VectorXf B;
+    Eigen::VectorXf X = Eigen::VectorXf::Zero(n);
+    implicitSystem(constraints, A, B);
+
+#ifdef EIGEN_SOLVER
     X = A.lu().solve(B);
+#else
+    // EigenĬתΪԼLUֽ
+    std::vector<float> rowMajorA(n * n), vectorB(B.data(), B.data() + n), vectorX;
+    Eigen::Map<Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>(rowMajorA.data(), n, n) = A;
+    solve(rowMajorA, vectorB, vectorX, n);
+    X = Eigen::Map<Eigen::VectorXf>(vectorX.data(), n);
+#endif // EIGEN_SOLVER
 
 #ifdef DATA_DEBUG
     std::cout << "A: " << std::endl << A << std::endl;
@@ -119,20 +218,208 @@ bool solveImplicitEquation(
 }
 
 // Լõֵ㣬ͼƬ߽
+void getZeroValuePoints(
+    int rows, int cols,
+    const std::vector<std::pair<Eigen::Vector3f, float>>& constraints,
+    const Eigen::VectorXf& weights, float P0, const Eigen::Vector3f& P,
+    std::vector<Polyline>& polylines,
+    int step = STEP)
+{
+    int xNum = cols / step + 1;
+    int yNum = rows / step + 1;
+    std::vector<float> field(xNum * yNum);
+#pragma omp parallel for
+    for (int i = 0; i < xNum; i++) {
+        for (int j = 0; j < yNum; j++) {
+            field[i * yNum + j] = implicitFunctionValue(Eigen::Vector3f(i * step, j * step, 0.0f), constraints, weights, P0, P);
+        }
+    }
+    marchingSquares([&](int i, int j) { return field[i * yNum + j]; }, xNum, yNum, step, polylines);
+}
+
 void getZeroValuePoints(
     int rows, int cols,
     const std::vector<std::pair<Eigen::Vector3f, float>>& constraints,
     const Eigen::VectorXf& weights, float P0, const Eigen::Vector3f& P,
     std::vector<Eigen::Vector3f>& result)
 {
-#pragma omp parallel
-    for (float x = 0.0f; x <= static_cast<float>(cols); x += STEP) {
-        for (float y = 0.0f; y <= static_cast<float>(rows); y += STEP) {
-            for (float z = 0.0f; z <= 0.0f; z += STEP) {
-                if (isZero(implicitFunctionValue(Eigen::Vector3f(x, y, z), constraints, weights, P0, P))) {
-                    result.push_back(Eigen::Vector3f(x, y, z));
-                }
+    std::vector<Polyline> polylines;
+    getZeroValuePoints(rows, cols, constraints, weights, P0, P, polylines);
+    flattenPolylines(polylines, result);
+}
+
+// ţٷѵݶȷͶӰf = 0ϣx = x - f * grad / |grad|^2
+// ֵľֵСʱ룬ݶȹСʱֹͣnormalsΪʱͶӰ㴦ָ״ĵλ
+void projectToZeroSet(
+    const ImplicitFunctionModel& model,
+    std::vector<Eigen::Vector3f>& points,
+    std::vector<Eigen::Vector3f>* normals = nullptr)
+{
+    if (normals) {
+        normals->resize(points.size());
+    }
+#pragma omp parallel for
+    for (int k = 0; k < static_cast<int>(points.size()); k++) {
+        Eigen::Vector3f x = points[k], gradient;
+        float value = implicitFunctionValueAndGradient(x, model, gradient);
+        gradient.z() = 0.0f;
+        for (int iteration = 0; iteration < NEWTON_ITERATIONS && fabs(value) > NEWTON_TOLERANCE; iteration++) {
+            float squaredNorm = gradient.squaredNorm();
+            if (squaredNorm < 1e-12f) {
+                break;
             }
+            Eigen::Vector3f delta = value / squaredNorm * gradient;
+            Eigen::Vector3f nextGradient;
+            float nextValue = implicitFunctionValueAndGradient(x - delta, model, nextGradient);
+            while (fabs(nextValue) >= fabs(value) && delta.squaredNorm() > 1e-8f) {
+                delta *= 0.5f;
+                nextValue = implicitFunctionValueAndGradient(x - delta, model, nextGradient);
+            }
+            if (fabs(nextValue) >= fabs(value)) {
+                break;
+            }
+            x -= delta;
+            value = nextValue;
+            gradient = nextGradient;
+            gradient.z() = 0.0f;
+        }
+        points[k] = x;
+        if (normals) {
+            float length = gradient.norm();
+            (*normals)[k] = length > 0.0f ? Eigen::Vector3f(-gradient / length) : Eigen::Vector3f::Zero();
+        }
+    }
+}
+
+// ڲΪstepĴmarching squaresֵ㣬ţٷͶӰȷֵ
+// sampleImplicitFunction()ֻͬǲΪstepÿ(cols + step - 1) / step㣬xy
+// STEPֱȡȣstepȡSTEP24ʱֵ416
+void getRefinedZeroValuePoints(
+    const ImplicitFunctionModel& model,
+    int step,
+    std::vector<Polyline>& polylines,
+    std::vector<std::vector<Eigen::Vector3f>>* normals = nullptr)
+{
+    int xNum = (model.cols + step - 1) / step;
+    int yNum = (model.rows + step - 1) / step;
+    std::vector<float> field(xNum * yNum);
+#pragma omp parallel for
+    for (int i = 0; i < xNum; i++) {
+        for (int j = 0; j < yNum; j++) {
+            field[i * yNum + j] = implicitFunctionValue(Eigen::Vector3f(i * step, j * step, 0.0f), model);
+        }
+    }
+    marchingSquares([&](int i, int j) { return field[i * yNum + j]; }, xNum, yNum, step, polylines);
+    if (normals) {
+        normals->resize(polylines.size());
+    }
+    for (int i = 0; i < polylines.size(); i++) {
+        projectToZeroSet(model, polylines[i].points, normals ? &(*normals)[i] : nullptr);
+    }
+}
+
+// ֵдļȻÿдǷպϣÿһָ״ĵλ
+bool writeContourFile(
+    const char* filePath,
+    const std::vector<Polyline>& polylines,
+    const std::vector<std::vector<Eigen::Vector3f>>& normals)
+{
+    std::ofstream file(filePath);
+    if (!file) {
+        return false;
+    }
+    file << std::setprecision(std::numeric_limits<float>::max_digits10);
+    file << polylines.size() << std::endl;
+    for (size_t i = 0; i < polylines.size(); i++) {
+        file << polylines[i].points.size() << ' ' << polylines[i].closed << '\n';
+        for (size_t k = 0; k < polylines[i].points.size(); k++) {
+            const auto& point = polylines[i].points[k];
+            const auto& normal = normals[i][k];
+            file << point.x() << ' ' << point.y() << ' ' << normal.x() << ' ' << normal.y() << '\n';
+        }
+    }
+    return static_cast<bool>(file);
+}
+
+// [x0, x1]  [y0, y1]ڲΪstepmarching squaresֵ㣬ţٷͶӰֵ
+// ֻϵԤȲֵСͲɵõ⾫ȵı߽
+void getRegionZeroValuePoints(
+    const ImplicitFunctionModel& model,
+    float x0, float y0, float x1, float y1,
+    float step,
+    std::vector<Polyline>& polylines)
+{
+    int xNum = static_cast<int>(std::ceil((x1 - x0) / step)) + 1;
+    int yNum = static_cast<int>(std::ceil((y1 - y0) / step)) + 1;
+    if (xNum < 2 || yNum < 2) {
+        return;
+    }
+    std::vector<float> field(xNum * yNum);
+#pragma omp parallel for
+    for (int i = 0; i < xNum; i++) {
+        for (int j = 0; j < yNum; j++) {
+            field[i * yNum + j] = implicitFunctionValue(Eigen::Vector3f(x0 + i * step, y0 + j * step, 0.0f), model);
+        }
+    }
+    size_t first = polylines.size();
+    marchingSquares([&](int i, int j) { return field[i * yNum + j]; }, xNum, yNum, step, polylines);
+    for (size_t k = first; k < polylines.size(); k++) {
+        for (auto& point : polylines[k].points) {
+            point += Eigen::Vector3f(x0, y0, 0.0f);
+        }
+        projectToZeroSet(model, polylines[k].points);
+    }
+}
+
+// ϵдļrowscolsP0PԼȻÿһԼꡢԼֵȨ
+bool writeModelFile(const char* filePath, const ImplicitFunctionModel& model)
+{
+    std::ofstream file(filePath);
+    if (!file) {
+        return false;
+    }
+    file << std::setprecision(std::numeric_limits<float>::max_digits10);
+    file << model.rows << std::endl << model.cols << std::endl << model.P0 << std::endl;
+    file << model.P.x() << ' ' << model.P.y() << ' ' << model.P.z() << std::endl;
+    file << model.constraints.size() << std::endl;
+    for (int i = 0; i < model.constraints.size(); i++) {
+        const auto& point = model.constraints[i].first;
+        file << point.x() << ' ' << point.y() << ' ' << point.z() << ' '
+            << model.constraints[i].second << ' ' << model.weights(i) << '\n';
+    }
+    return static_cast<bool>(file);
+}
+
+bool readModelFile(const char* filePath, ImplicitFunctionModel& model)
+{
+    std::ifstream file(filePath);
+    if (!file) {
+        return false;
+    }
+    int constraintNum;
+    file >> model.rows >> model.cols >> model.P0 >> model.P.x() >> model.P.y() >> model.P.z() >> constraintNum;
+    if (!file || constraintNum < 0) {
+        return false;
+    }
+    model.constraints.resize(constraintNum);
+    model.weights.resize(constraintNum);
+    for (int i = 0; i < constraintNum; i++) {
+        auto& point = model.constraints[i].first;
+        file >> point.x() >> point.y() >> point.z() >> model.constraints[i].second >> model.weights(i);
+    }
+    return static_cast<bool>(file);
+}
+
+// STEPͼƬֵ˳дļ˳һ£xy
+void sampleImplicitFunction(const ImplicitFunctionModel& model, std::vector<float>& field)
+{
+    int xNum = (model.cols + STEP - 1) / STEP;
+    int yNum = (model.rows + STEP - 1) / STEP;
+    field.resize(xNum * yNum);
+#pragma omp parallel for
+    for (int i = 0; i < xNum; i++) {
+        for (int j = 0; j < yNum; j++) {
+            field[i * yNum + j] = implicitFunctionValue(Eigen::Vector3f(i * STEP, j * STEP, 0.0f), model);
         }
     }
 }
@@ -0,0 +1,217 @@
+#ifndef __INTERPOLATION_WORKER_HPP__
+#define __INTERPOLATION_WORKER_HPP__
+
+#define FRAME_POOL_SIZE 3
+#include "../algorithm/VertexArena.hpp"
+#include <Eigen/Core>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ߵζУCapacityΪ2
+template <typename T, size_t Capacity> class SpscQueue {
+public:
+	bool push(const T& value) {
+		size_t tail = this->tail.load(std::memory_order_relaxed);
+		if (tail - head.load(std::memory_order_acquire) == Capacity) {
+			return false;
+		}
+		buffer[tail & (Capacity - 1)] = value;
+		this->tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool pop(T& value) {
+		size_t head = this->head.load(std::memory_order_relaxed);
+		if (head == tail.load(std::memory_order_acquire)) {
+			return false;
+		}
+		value = buffer[head & (Capacity - 1)];
+		this->head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+private:
+	static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of 2");
+	T buffer[Capacity];
+	alignas(64) std::atomic<size_t> head{ 0 };
+	alignas(64) std::atomic<size_t> tail{ 0 };
+};
+
+// ȡǣύ˸µȨغڽеļgeneration
+struct CancelToken {
+	const std::atomic<unsigned>* generation = nullptr;
+	unsigned expected = 0;
+
+	bool cancelled() const {
+		return generation && generation->load(std::memory_order_relaxed) != expected;
+	}
+};
+
+// һ֡OpenGLݣĺͱߵĶ˵㣬ΪͼƬ꣬СĵλΪֽ
+// ݴڿڴУ֡ѭʹʱڴصڴҲԹ־ӳOpenGL壬
+// ʱֱ̨߳дGPUɼڴ
+// hullΪһ֡е͹ʱ룬ͼƬ꣩Ⱦ߳İΧ޳ӿ֡
+struct FrameData {
+	float weight = 0.0f;
+	// ֡еλã֡ʱΪ-1
+	int slot = -1;
+	int pointCenterSize = 0;
+	int edgePointSize = 0;
+	VertexArena pointCenters;
+	VertexArena edgePointVertices;
+	std::vector<Eigen::Vector3f> hull;
+};
+
+// ֵ̨̣߳Ⱦ߳ύȨأ̨̼߳㶥ݣɵ֡ͨнȾ߳
+// Ȩصʱȡڵļ㣻֮֡ѭʹãȾ߳ʼճеǰʾһ֡
+class InterpolationWorker {
+public:
+	// taskfalseʾ㱻ȡʧܣʱ֡
+	using Task = std::function<bool(float weight, const CancelToken& cancel, FrameData& frame)>;
+	// ûдȨʱ̷̨߳ãfalseʾʱûйֱһύȨ
+	using IdleTask = std::function<bool(const CancelToken& cancel)>;
+	// ֡ڹ黹̨֮߳ǰãȴGPU֡ڴ
+	using Release = std::function<void(FrameData& frame)>;
+
+	InterpolationWorker(Task task, IdleTask idleTask = nullptr)
+		: task(std::move(task)), idleTask(std::move(idleTask)) {
+		for (int i = 0; i < FRAME_POOL_SIZE; i++) {
+			pool[i].slot = i;
+			freeFrames.push(&pool[i]);
+		}
+		thread = std::thread(&InterpolationWorker::run, this);
+	}
+
+	~InterpolationWorker() {
+		stop();
+	}
+
+	// ȡڽеļ㲢̨̣߳֡صڴڴ֮ٱд
+	void stop() {
+		if (!thread.joinable()) {
+			return;
+		}
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+			generation++;
+		}
+		condition.notify_one();
+		thread.join();
+	}
+
+	// Ⱦ̣߳ύµȨأڽеļ֮ȡ
+	void post(float weight) {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			latestWeight = weight;
+			generation++;
+		}
+		condition.notify_one();
+	}
+
+	// Ⱦ̣߳ȡɵһ֡Ϊǰ֡滻֡release黹̨̣߳û֡ʱnullptr
+	FrameData* poll(const Release& release = nullptr) {
+		FrameData* frame;
+		FrameData* latest = nullptr;
+		bool released = false;
+		while (readyFrames.pop(frame)) {
+			if (latest) {
+				if (release) {
+					release(*latest);
+				}
+				released |= freeFrames.push(latest);
+			}
+			latest = frame;
+		}
+		if (latest) {
+			if (current) {
+				if (release) {
+					release(*current);
+				}
+				released |= freeFrames.push(current);
+			}
+			current = latest;
+		}
+		if (released) {
+			// ȼ̨֪ͨ߳ڼfreeFramesͿʼȴ֮䲻֪ͨ
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+			}
+			condition.notify_one();
+		}
+		return current;
+	}
+
+private:
+	Task task;
+	IdleTask idleTask;
+	FrameData pool[FRAME_POOL_SIZE];
+	SpscQueue<FrameData*, 4> readyFrames;
+	SpscQueue<FrameData*, 4> freeFrames;
+	FrameData* current = nullptr;
+
+	std::thread thread;
+	std::mutex mutex;
+	std::condition_variable condition;
+	std::atomic<unsigned> generation{ 0 };
+	float latestWeight = 0.0f;
+	bool stopping = false;
+
+	void run() {
+		unsigned processed = 0;
+		// ȡ֡һμʹąֻ̃߳freeFramesȡ֡з֡
+		FrameData* spare = nullptr;
+		bool idle = true;
+		while (true) {
+			float weight;
+			unsigned taskGeneration;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				while (idle && idleTask && !stopping && generation.load() == processed) {
+					lock.unlock();
+					idle = idleTask(CancelToken{ &generation, processed });
+					lock.lock();
+				}
+				condition.wait(lock, [&] { return stopping || generation.load() != processed; });
+				if (stopping) {
+					return;
+				}
+				weight = latestWeight;
+				taskGeneration = generation.load();
+			}
+			processed = taskGeneration;
+			idle = true;
+
+			CancelToken cancel{ &generation, taskGeneration };
+			FrameData* frame = spare;
+			spare = nullptr;
+			if (!frame) {
+				// ֡Ⱦ߳ʱȴpoll()黹µȨػʱٵȴ
+				std::unique_lock<std::mutex> lock(mutex);
+				condition.wait(lock, [&] { return stopping || cancel.cancelled() || freeFrames.pop(frame); });
+				if (stopping) {
+					return;
+				}
+			}
+			if (!frame) {
+				continue;
+			}
+
+			frame->weight = weight;
+			if (task(weight, cancel, *frame) && !cancel.cancelled()) {
+				readyFrames.push(frame);
+			}
+			else {
+				spare = frame;
+			}
+		}
+	}
+};
+
+#endif
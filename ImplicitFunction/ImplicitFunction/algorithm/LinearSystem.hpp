@@ -1,58 +1,120 @@
 #ifndef __LINEAR_SYSTEM_HPP__
 #define __LINEAR_SYSTEM_HPP__
 
-#include <glm/glm.hpp>
-#include <glm/gtc/matrix_transform.hpp>
-#include <glm/gtc/type_ptr.hpp>
-#include <imgui.h>
-#include <backends/imgui_impl_glfw.h>
-#include <backends/imgui_impl_opengl3.h>
+#define LU_BLOCK_SIZE 64
 #include <vector>
+#include <iostream>
+#include <algorithm>
+#include <cmath>
 
-template <typename T> void lu(const std::vector<std::vector<T>>& a, std::vector<std::vector<T>>& l, vector<vector<T>>& u, int n)
+// ܾ洢Ԫ(i, j)λa[i * n + j]
+
+// LUֽaͬʱŵλǾLԽߣǾUpiv[k]Ϊkkнк
+template <typename T> struct LUFactorization {
+    int n = 0;
+    std::vector<T> a;
+    std::vector<int> piv;
+};
+
+// 
+template <typename T> void swapRows(std::vector<T>& a, int n, int r1, int r2)
 {
-    int i = 0, j = 0, k = 0;
-    for (i = 0; i < n; i++)
-    {
-        for (j = 0; j < n; j++)
-        {
-            if (j < i)
-                l[j][i] = 0;
-            else
-            {
-                l[j][i] = a[j][i];
-                for (k = 0; k < i; k++)
-                {
-                    l[j][i] = l[j][i] - l[j][k] * u[k][i];
+    if (r1 == r2) {
+        return;
+    }
+    std::swap_ranges(a.begin() + r1 * n, a.begin() + (r1 + 1) * n, a.begin() + r2 * n);
+}
+
+// ֿ鲿ԪLUֽ⣬ԭؽУPA = LU
+// ÿζԿΪLU_BLOCK_SIZEֽֿ⣬ҲU12µβӾ
+// ԪΪ0УDIMENSIONΪ3еz궼Ϊ0ʱzУֱEigen::PartialPivLUһ
+template <typename T> void lu(std::vector<T>& a, std::vector<int>& piv, int n)
+{
+    piv.resize(n);
+    for (int k0 = 0; k0 < n; k0 += LU_BLOCK_SIZE) {
+        int k1 = std::min(k0 + LU_BLOCK_SIZE, n);
+
+        // ֽ⣺ֻڵУн
+        for (int k = k0; k < k1; k++) {
+            int p = k;
+            T maxValue = std::abs(a[k * n + k]);
+            for (int i = k + 1; i < n; i++) {
+                T value = std::abs(a[i * n + k]);
+                if (value > maxValue) {
+                    maxValue = value;
+                    p = i;
+                }
+            }
+            piv[k] = p;
+            if (maxValue == T(0)) {
+                continue;
+            }
+            swapRows(a, n, k, p);
+
+            const T* rowK = &a[k * n];
+            T pivot = rowK[k];
+            for (int i = k + 1; i < n; i++) {
+                T* rowI = &a[i * n];
+                T lik = rowI[k] / pivot;
+                rowI[k] = lik;
+                for (int j = k + 1; j < k1; j++) {
+                    rowI[j] -= lik * rowK[j];
                 }
             }
         }
-        for (j = 0; j < n; j++)
-        {
-            if (j < i)
-                u[i][j] = 0;
-            else if (j == i)
-                u[i][j] = 1;
-            else
-            {
-                u[i][j] = a[i][j] / l[i][i];
-                for (k = 0; k < i; k++)
-                {
-                    u[i][j] = u[i][j] - ((l[i][k] * u[k][j]) / l[i][i]);
+        if (k1 == n) {
+            break;
+        }
+
+        // U12 = L11^-1 * A12
+        for (int k = k0; k < k1; k++) {
+            const T* rowK = &a[k * n];
+            for (int i = k + 1; i < k1; i++) {
+                T* rowI = &a[i * n];
+                T lik = rowI[k];
+                for (int j = k1; j < n; j++) {
+                    rowI[j] -= lik * rowK[j];
+                }
+            }
+        }
+
+        // A22 = A22 - L21 * U12黮Ϊ໥и
+        int blocks = (n - k1 + LU_BLOCK_SIZE - 1) / LU_BLOCK_SIZE;
+#pragma omp parallel for collapse(2) schedule(dynamic)
+        for (int ib = 0; ib < blocks; ib++) {
+            for (int jb = 0; jb < blocks; jb++) {
+                int i0 = k1 + ib * LU_BLOCK_SIZE, i1 = std::min(i0 + LU_BLOCK_SIZE, n);
+                int j0 = k1 + jb * LU_BLOCK_SIZE, j1 = std::min(j0 + LU_BLOCK_SIZE, n);
+                for (int i = i0; i < i1; i++) {
+                    T* rowI = &a[i * n];
+                    for (int k = k0; k < k1; k++) {
+                        T lik = rowI[k];
+                        const T* rowK = &a[k * n];
+                        for (int j = j0; j < j1; j++) {
+                            rowI[j] -= lik * rowK[j];
+                        }
+                    }
                 }
             }
         }
     }
 }
 
-template <typename T> void output(const std::vector<std::vector<T>>& x, int n)
+template <typename T> void lu(const std::vector<T>& A, LUFactorization<T>& factorization, int n)
+{
+    factorization.n = n;
+    factorization.a = A;
+    lu(factorization.a, factorization.piv, n);
+}
+
+template <typename T> void output(const std::vector<T>& x, int n)
 {
     int i = 0, j = 0;
     for (i = 0; i < n; i++)
     {
         for (j = 0; j < n; j++)
         {
-            std::cout << x[i][j] << "\t\t";
+            std::cout << x[i * n + j] << "\t\t";
         }
         std::cout << "\n";
     }
@@ -69,49 +131,102 @@ template <typename T> void output2(const std::vector<T>& x, int n)
     }
 }
 
-template <typename T> void LYCompute(const std::vector<std::vector<T>> L, const std::vector<T>& B, std::vector<T>& Y, int n)
+// ǰL * Y = BLΪλǾֻj < i
+template <typename T> void LYCompute(const std::vector<T>& LU, const std::vector<T>& B, std::vector<T>& Y, int n)
 {
     for (int i = 0; i < n; i++)
     {
+        const T* rowI = &LU[i * n];
         T sum = 0;
-        T value = L[i][i];
-        for (int j = 0; j < n; j++)
+        for (int j = 0; j < i; j++)
         {
-            T temp = L[i][j] * Y[j];
-            sum += temp;
+            sum += rowI[j] * Y[j];
+        }
+        Y[i] = B[i] - sum;
+    }
+}
 
+// شU * X = Yֻj > iԽΪ0ʱӦδ֪ȡ0
+template <typename T> void UXCompute(const std::vector<T>& LU, const std::vector<T>& Y, std::vector<T>& X, int n)
+{
+    for (int i = n - 1; i >= 0; i--)
+    {
+        const T* rowI = &LU[i * n];
+        T sum = 0;
+        for (int j = i + 1; j < n; j++)
+        {
+            sum += rowI[j] * X[j];
         }
-        Y[i] = (B[i] - sum) / value;
+        X[i] = rowI[i] == T(0) ? T(0) : (Y[i] - sum) / rowI[i];
     }
+}
 
+// еķֽA * X = B
+template <typename T> void solve(const LUFactorization<T>& factorization, const std::vector<T>& B, std::vector<T>& X)
+{
+    int n = factorization.n;
+    std::vector<T> PB(B.begin(), B.begin() + n);
+    for (int k = 0; k < n; k++) {
+        std::swap(PB[k], PB[factorization.piv[k]]);
+    }
+    std::vector<T> Y(n);
+    X.resize(n);
+    // L * Y = P * B
+    LYCompute(factorization.a, PB, Y, n);
+    // U * X = Y
+    UXCompute(factorization.a, Y, X, n);
 }
 
-template <typename T> void UXCompute(const std::vector<std::vector<T>>& U, const std::vector<T>& Y, std::vector<T>& X, int n)
+// ĽXΪֵķֽA * X = BÿεX += factorization^-1 * (B - A * X)
+// вdoubleۼӣԲвtoleranceʱtrueвֵĲвɢmaxIterationsδʱfalse
+// ̬ϲвһ½ֻڷɢʱǰ
+// ÿεֻO(n^2)AֽľСʱ·ֽö
+template <typename T> bool refine(
+    const std::vector<T>& A, const std::vector<T>& B, const LUFactorization<T>& factorization,
+    std::vector<T>& X, int maxIterations, double tolerance, int& iterations)
 {
-    for (int i = n - 1; i >= 0; i--) {
-        if (i == (n - 1))
-            X[n - 1] = Y[n - 1];
-        else {
-            T value = Y[i];
-            T temp = 0;
-            for (int j = n - 1; j > 0; j--) {
-                temp -= U[i][j] * X[j];
+    int n = factorization.n;
+    double normB = 0.0;
+    for (int i = 0; i < n; i++) {
+        normB += static_cast<double>(B[i]) * B[i];
+    }
+    normB = std::sqrt(normB);
+    std::vector<T> R(n), D;
+    double initialResidual = 0.0;
+    for (iterations = 0; ; iterations++) {
+        double residual = 0.0;
+        for (int i = 0; i < n; i++) {
+            const T* rowI = &A[i * n];
+            double sum = B[i];
+            for (int j = 0; j < n; j++) {
+                sum -= static_cast<double>(rowI[j]) * X[j];
             }
-            X[i] = temp + value;
+            R[i] = static_cast<T>(sum);
+            residual += sum * sum;
+        }
+        residual = std::sqrt(residual);
+        if (residual <= tolerance * normB) {
+            return true;
+        }
+        if (iterations == 0) {
+            initialResidual = residual;
+        }
+        else if (iterations == maxIterations || residual > initialResidual) {
+            return false;
+        }
+        solve(factorization, R, D);
+        for (int i = 0; i < n; i++) {
+            X[i] += D[i];
         }
     }
 }
 
-template <typename T> void solve(const std::vector<std::vector<T>>& A, const std::vector<T>& B, std::vector<T>& X, int n) {
-    vector<vector<T>> L(n, vector<T>(n, 0.0f));
-    vector<vector<T>> U(n, vector<T>(n, 0.0f));
-    vector<T> Y(n, 0.0f);
-    // A = L * U
-    lu(A, L, U, n);
-    // L * Y = B
-    LYCompute(L, B, Y, n);
-    // U * X = Y
-    UXCompute(U, Y, X, n);
+template <typename T> void solve(const std::vector<T>& A, const std::vector<T>& B, std::vector<T>& X, int n)
+{
+    LUFactorization<T> factorization;
+    // P * A = L * U
+    lu(A, factorization, n);
+    solve(factorization, B, X);
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,195 @@
+#ifndef __MARCHING_SQUARES_HPP__
+#define __MARCHING_SQUARES_HPP__
+
+#include <Eigen/Dense>
+#include <Eigen/Core>
+#include <vector>
+#include <algorithm>
+#include <utility>
+
+// (i, j)Ӧ(i * step, j * step)ֵxy˳ţindex = i * yNum + j
+// ֵ0ĵ״ڣСڵ0ĵ״⣬ֵΪֵΪ0λ
+
+// һߣclosedΪtrueʱβ׵㲻ĩβظ
+struct Polyline {
+	std::vector<Eigen::Vector3f> points;
+	bool closed = false;
+};
+
+// һԪڵĵֵ߶ΣedgesΪߵı
+// (i, j)-(i + 1, j)ıΪ(i * yNum + j) * 2(i, j)-(i, j + 1)ıΪ(i * yNum + j) * 2 + 1
+struct MarchingSegment {
+	int edges[2];
+	Eigen::Vector3f points[2];
+};
+
+// ϵԲֵ
+inline Eigen::Vector3f edgeCrossing(float x1, float y1, float v1, float x2, float y2, float v2) {
+	float t = v1 / (v1 - v2);
+	return Eigen::Vector3f(x1 + t * (x2 - x1), y1 + t * (y2 - y1), 0.0f);
+}
+
+// ռԪi[i0, i1)j[j0, j1)ڵĵֵ߶Σvalue(i, j)(i, j)ֵ
+// 㵥Ԫĸǵƽֵжӷʽ
+template <typename F> void marchingSquaresCells(
+	F&& value, int yNum, float step,
+	int i0, int i1, int j0, int j1,
+	std::vector<MarchingSegment>& segments)
+{
+	// ĸǵ㰴(0, 0), (1, 0), (1, 1), (0, 1)˳߰¡ҡϡ˳
+	static const int cornerEdges[4][2] = { { 0, 3 }, { 0, 1 }, { 1, 2 }, { 2, 3 } };
+	static const int edgeCorners[4][2] = { { 0, 1 }, { 1, 2 }, { 3, 2 }, { 0, 3 } };
+	static const int cornerOffsets[4][2] = { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 1 } };
+	for (int i = i0; i < i1; i++) {
+		for (int j = j0; j < j1; j++) {
+			float v[4] = { value(i, j), value(i + 1, j), value(i + 1, j + 1), value(i, j + 1) };
+			bool inside[4] = { v[0] > 0.0f, v[1] > 0.0f, v[2] > 0.0f, v[3] > 0.0f };
+			if (inside[0] == inside[1] && inside[1] == inside[2] && inside[2] == inside[3]) {
+				continue;
+			}
+			int edgeIds[4] = {
+				(i * yNum + j) * 2,
+				((i + 1) * yNum + j) * 2 + 1,
+				(i * yNum + j + 1) * 2,
+				(i * yNum + j) * 2 + 1
+			};
+			Eigen::Vector3f crossings[4];
+			int crossingEdges[4], crossingNum = 0;
+			for (int e = 0; e < 4; e++) {
+				int a = edgeCorners[e][0], b = edgeCorners[e][1];
+				if (inside[a] != inside[b]) {
+					crossings[e] = edgeCrossing(
+						(i + cornerOffsets[a][0]) * step, (j + cornerOffsets[a][1]) * step, v[a],
+						(i + cornerOffsets[b][0]) * step, (j + cornerOffsets[b][1]) * step, v[b]);
+					crossingEdges[crossingNum++] = e;
+				}
+			}
+			if (crossingNum == 2) {
+				int e1 = crossingEdges[0], e2 = crossingEdges[1];
+				segments.push_back({ { edgeIds[e1], edgeIds[e2] }, { crossings[e1], crossings[e2] } });
+			}
+			else {
+				// 㣺ĵŲͬǵһ߶п
+				bool centerInside = (v[0] + v[1] + v[2] + v[3]) * 0.25f > 0.0f;
+				for (int c = 0; c < 4; c++) {
+					if (inside[c] != centerInside) {
+						int e1 = cornerEdges[c][0], e2 = cornerEdges[c][1];
+						segments.push_back({ { edgeIds[e1], edgeIds[e2] }, { crossings[e1], crossings[e2] } });
+					}
+				}
+			}
+		}
+	}
+}
+
+// ߶ʱʹõĻ壬֡ظʹʱٷڴ
+struct ChainScratch {
+	std::vector<std::pair<int, int>> edgeEntries;
+	std::vector<int> neighbors;
+	std::vector<char> visited;
+};
+
+// ߶ΰβӣõߣȴֻһĶ˵㿪ʼõߣʣµΪպ
+// ÿεbegin()add(point)end(closed)
+template <typename Begin, typename Add, typename End> void chainSegments(
+	const std::vector<MarchingSegment>& segments, ChainScratch& scratch,
+	Begin&& begin, Add&& add, End&& end)
+{
+	int n = segments.size();
+	// ÿ౻ڵԪ߶ιߵıڵΪھ
+	// neighbors[s * 2 + k]Ϊs߶ιkߵ߶ΣûʱΪ-1
+	auto& edgeEntries = scratch.edgeEntries;
+	auto& neighbors = scratch.neighbors;
+	auto& visited = scratch.visited;
+	edgeEntries.clear();
+	for (int s = 0; s < n; s++) {
+		edgeEntries.emplace_back(segments[s].edges[0], s * 2);
+		edgeEntries.emplace_back(segments[s].edges[1], s * 2 + 1);
+	}
+	std::sort(edgeEntries.begin(), edgeEntries.end());
+	neighbors.assign(n * 2, -1);
+	for (size_t e = 0; e + 1 < edgeEntries.size(); e++) {
+		if (edgeEntries[e].first == edgeEntries[e + 1].first) {
+			neighbors[edgeEntries[e].second] = edgeEntries[e + 1].second / 2;
+			neighbors[edgeEntries[e + 1].second] = edgeEntries[e].second / 2;
+			e++;
+		}
+	}
+	visited.assign(n, 0);
+	auto walk = [&](int s, int startSide) {
+		begin();
+		add(segments[s].points[startSide]);
+		int side = 1 - startSide;
+		while (true) {
+			visited[s] = 1;
+			int edge = segments[s].edges[side];
+			int next = neighbors[s * 2 + side];
+			if (next < 0) {
+				add(segments[s].points[side]);
+				end(false);
+				return;
+			}
+			if (visited[next]) {
+				end(true);
+				return;
+			}
+			add(segments[s].points[side]);
+			side = segments[next].edges[0] == edge ? 1 : 0;
+			s = next;
+		}
+	};
+	for (int s = 0; s < n; s++) {
+		if (visited[s]) {
+			continue;
+		}
+		for (int k = 0; k < 2; k++) {
+			if (neighbors[s * 2 + k] < 0) {
+				walk(s, k);
+				break;
+			}
+		}
+	}
+	for (int s = 0; s < n; s++) {
+		if (!visited[s]) {
+			walk(s, 0);
+		}
+	}
+}
+
+void chainSegments(const std::vector<MarchingSegment>& segments, std::vector<Polyline>& polylines)
+{
+	ChainScratch scratch;
+	chainSegments(segments, scratch,
+		[&]() { polylines.emplace_back(); },
+		[&](const Eigen::Vector3f& point) { polylines.back().points.push_back(point); },
+		[&](bool closed) { polylines.back().closed = closed; });
+}
+
+// ߶βϵĵηpointschainSegments()flattenPolylines()Ľͬм
+void chainSegmentPoints(const std::vector<MarchingSegment>& segments, std::vector<Eigen::Vector3f>& points, ChainScratch& scratch)
+{
+	chainSegments(segments, scratch,
+		[]() {},
+		[&](const Eigen::Vector3f& point) { points.push_back(point); },
+		[](bool) {});
+}
+
+// xNum  yNummarching squaresõصֵ
+template <typename F> void marchingSquares(
+	F&& value, int xNum, int yNum, float step,
+	std::vector<Polyline>& polylines)
+{
+	std::vector<MarchingSegment> segments;
+	marchingSquaresCells(value, yNum, step, 0, xNum - 1, 0, yNum - 1, segments);
+	chainSegments(segments, polylines);
+}
+
+// ϵĵηpoints
+void flattenPolylines(const std::vector<Polyline>& polylines, std::vector<Eigen::Vector3f>& points)
+{
+	for (const auto& polyline : polylines) {
+		points.insert(points.end(), polyline.points.begin(), polyline.points.end());
+	}
+}
+
+#endif
@@ -0,0 +1,241 @@
+#ifndef __MODEL_CACHE_HPP__
+#define __MODEL_CACHE_HPP__
+
+#define CACHE_MAX_SIZE 268435456
+#define CACHE_VERSION 2
+#include "../algorithm/ImplicitFunction.hpp"
+#include "../algorithm/ImageProcess.hpp"
+#include "../algorithm/SvgProcess.hpp"
+#include <Eigen/Dense>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+// FNV-1aϣ
+uint64_t fnv1a(const void* data, size_t size, uint64_t hash = 14695981039346656037ull) {
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+	for (size_t i = 0; i < size; i++) {
+		hash ^= bytes[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+struct CacheStatistics {
+	int hits = 0;
+	int misses = 0;
+	int evictions = 0;
+};
+
+// Ĵ̻棺ͼƬݺȡĹϣΪԼϵͿѡĲֵ
+// ܴСmaxSizeʱʹʱ̭
+class ModelCache {
+public:
+	ModelCache(const std::string& directory, uintmax_t maxSize = CACHE_MAX_SIZE)
+		: directory(directory), maxSize(maxSize) {
+		std::error_code error;
+		std::filesystem::create_directories(directory, error);
+	}
+
+	// ͼƬĻͼƬݡԼȡԼʱȡк꣬ͼƬ޷ȡʱfalse
+	bool key(const char* imagePath, uint64_t& result) const {
+		std::ifstream file(imagePath, std::ios::binary);
+		if (!file) {
+			return false;
+		}
+		std::vector<char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+		result = fnv1a(bytes.data(), bytes.size());
+		std::string parameters = std::to_string(CACHE_VERSION)
+			+ "|" + std::to_string(SAMPLE_NUM) + "|" + std::to_string(OFFSET) + "|" + std::to_string(EPSILON)
+			+ "|" + std::to_string(STEP) + "|" + std::to_string(DIMENSION) + "|" + RBF_KERNEL;
+#ifdef EIGEN_SOLVER
+		parameters += "|eigen";
+#endif // EIGEN_SOLVER
+		if (isSvgPath(imagePath)) {
+			// processSvg()չƽߵݲϸֲͼ
+			parameters += "|svg|" + std::to_string(SVG_FLATNESS) + "|" + std::to_string(SVG_MAX_DEPTH);
+		}
+#ifdef SDF_MODE
+		else {
+			// distanceFieldImage()ֻȡߵֵȡԼ
+			parameters += "|sdf|" + std::to_string(TRACE_THRESHOLD);
+		}
+#else
+		else {
+#if defined(PYRAMID_MODE)
+			// processImage5()ߵֵͽвС
+			parameters += "|pyramid|" + std::to_string(TRACE_THRESHOLD) + "|" + std::to_string(PYRAMID_SPACING);
+#elif defined(TRACE_MODE)
+			// processImage4()ߵֵ
+			parameters += "|trace|" + std::to_string(TRACE_THRESHOLD);
+#else
+			// processImage3()cv::Canny()ĲС
+			parameters += "|canny|" + std::to_string(LOW_THRESHOLD) + "|" + std::to_string(HIGH_THRESHOLD)
+				+ "|" + std::to_string(APERTURE_SIZE) + "|" + std::to_string(AREA_LIMIT);
+#endif
+		}
+#endif // SDF_MODE
+#ifdef RESAMPLE_MODE
+		parameters += "|resample|" + std::to_string(BOUNDARY_TOLERANCE) + "|" + std::to_string(MAX_MATRIX_DIMENSION);
+#endif // RESAMPLE_MODE
+		result = fnv1a(parameters.data(), parameters.size(), result);
+		return true;
+	}
+
+	bool load(uint64_t key, ImplicitFunctionModel& model, std::vector<float>* field = nullptr) {
+		std::filesystem::path path = entryPath(key);
+		std::ifstream file(path, std::ios::binary);
+		if (!file || !read(file, model, field)) {
+			statistics.misses++;
+			return false;
+		}
+		file.close();
+		// ޸ʱΪʹʱ
+		std::error_code error;
+		std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), error);
+		statistics.hits++;
+		return true;
+	}
+
+	void store(uint64_t key, const ImplicitFunctionModel& model, const std::vector<float>* field = nullptr) {
+		std::ofstream file(entryPath(key), std::ios::binary);
+		if (!file) {
+			std::cerr << "Failed to write cache entry." << std::endl;
+			return;
+		}
+		write(file, model, field);
+		file.close();
+		evict();
+	}
+
+	const CacheStatistics& getStatistics() const {
+		return statistics;
+	}
+
+private:
+	std::string directory;
+	uintmax_t maxSize;
+	CacheStatistics statistics;
+
+	std::filesystem::path entryPath(uint64_t key) const {
+		char name[32];
+		snprintf(name, sizeof(name), "%016llx.cache", static_cast<unsigned long long>(key));
+		return std::filesystem::path(directory) / name;
+	}
+
+	template <typename T> static void writeValue(std::ofstream& file, const T& value) {
+		file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	template <typename T> static bool readValue(std::ifstream& file, T& value) {
+		return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+	}
+
+	static bool readFloats(std::ifstream& file, float* values, size_t count) {
+		return static_cast<bool>(file.read(reinterpret_cast<char*>(values), count * sizeof(float)));
+	}
+
+	static void write(std::ofstream& file, const ImplicitFunctionModel& model, const std::vector<float>* field) {
+		writeValue(file, static_cast<int>(CACHE_VERSION));
+		writeValue(file, model.rows);
+		writeValue(file, model.cols);
+		writeValue(file, static_cast<int>(model.constraints.size()));
+		for (const auto& constraint : model.constraints) {
+			file.write(reinterpret_cast<const char*>(constraint.first.data()), 3 * sizeof(float));
+			writeValue(file, constraint.second);
+		}
+		file.write(reinterpret_cast<const char*>(model.weights.data()), model.weights.size() * sizeof(float));
+		writeValue(file, model.P0);
+		file.write(reinterpret_cast<const char*>(model.P.data()), 3 * sizeof(float));
+		int fieldSize = field ? static_cast<int>(field->size()) : 0;
+		writeValue(file, fieldSize);
+		if (fieldSize > 0) {
+			file.write(reinterpret_cast<const char*>(field->data()), fieldSize * sizeof(float));
+		}
+	}
+
+	// ļܱضϻ𻵣ȼǷٷڴ棬ÿζȡ״̬κһԶΪδ
+	// ȶֲУδʱĶmodelfield߿ֱ
+	static bool read(std::ifstream& file, ImplicitFunctionModel& model, std::vector<float>* field) {
+		ImplicitFunctionModel result;
+		std::vector<float> values;
+		int version, rows, cols, constraintNum, fieldSize;
+		if (!readValue(file, version) || version != CACHE_VERSION) {
+			return false;
+		}
+		if (!readValue(file, rows) || !readValue(file, cols) || !readValue(file, constraintNum)) {
+			return false;
+		}
+		// ԼMAX_MATRIX_DIMENSIONɵž볡ûԼconstraintNumΪ0
+		if (rows <= 0 || cols <= 0 || constraintNum < 0 || constraintNum > MAX_MATRIX_DIMENSION - DIMENSION - 1) {
+			return false;
+		}
+		long long xNum = (cols + STEP - 1) / STEP;
+		long long yNum = (rows + STEP - 1) / STEP;
+		result.rows = rows;
+		result.cols = cols;
+		result.constraints.resize(constraintNum);
+		for (auto& constraint : result.constraints) {
+			if (!readFloats(file, constraint.first.data(), 3) || !readValue(file, constraint.second)) {
+				return false;
+			}
+		}
+		result.weights.resize(constraintNum);
+		if (!readFloats(file, result.weights.data(), constraintNum) || !readValue(file, result.P0) ||
+			!readFloats(file, result.P.data(), 3) || !readValue(file, fieldSize)) {
+			return false;
+		}
+		// ֵĸֻ0ûб棩ͼƬСӦ
+		if (fieldSize != 0 && fieldSize != xNum * yNum) {
+			return false;
+		}
+		// ҪֵûʱΪδ
+		if (field) {
+			if (fieldSize == 0) {
+				return false;
+			}
+			values.resize(fieldSize);
+			if (!readFloats(file, values.data(), fieldSize)) {
+				return false;
+			}
+			field->swap(values);
+		}
+		model = std::move(result);
+		return true;
+	}
+
+	// ̭δʹõĻļֱܴСmaxSize
+	void evict() {
+		std::error_code error;
+		std::vector<std::filesystem::directory_entry> entries;
+		uintmax_t totalSize = 0;
+		for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+			if (entry.is_regular_file() && entry.path().extension() == ".cache") {
+				entries.push_back(entry);
+				totalSize += entry.file_size();
+			}
+		}
+		if (totalSize <= maxSize) {
+			return;
+		}
+		std::sort(entries.begin(), entries.end(), [](const auto& e1, const auto& e2) {
+			return e1.last_write_time() < e2.last_write_time();
+		});
+		for (const auto& entry : entries) {
+			if (totalSize <= maxSize) {
+				break;
+			}
+			uintmax_t size = entry.file_size();
+			if (std::filesystem::remove(entry.path(), error)) {
+				totalSize -= size;
+				statistics.evictions++;
+			}
+		}
+	}
+};
+
+#endif
@@ -3,9 +3,15 @@
 
 #define POINT_SIZE 1.0f
 #define ALPHA 100.0f
+#define CONVEX_HULL_CHUNK 262144
 #include <iostream>
 #include <vector>
+#include <array>
 #include <algorithm>
+#include <cmath>
+#include <cfloat>
+#include <span>
+#include <opencv2/imgproc/imgproc.hpp>
 #include <glm/glm.hpp>
 #include <Eigen/Dense>
 #include <Eigen/Core>
@@ -16,105 +22,27 @@ bool isEqual(float x, float y) {
 	return fabs(x - y) < 1e-10;
 }
 
-void pointConvertTriangle(
-	const std::vector<Eigen::Vector3f>& points,
-	std::vector<Eigen::Vector3f>& actualPoints)
+// 8ΪԵĵƫƣkxyzƫƵķŷֱkĵ012λ
+// 3612ΣÿΪһʵƣչΪ36
+void pointCubeMesh(
+	std::vector<Eigen::Vector3f>& vertices,
+	std::vector<unsigned int>& indices)
 {
-	for (const auto& point : points) {
-		actualPoints.push_back(Eigen::Vector3f(point.x() - POINT_SIZE, point.y() - POINT_SIZE, point.z() - POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() + POINT_SIZE, point.y() - POINT_SIZE, point.z() - POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() + POINT_SIZE, point.y() + POINT_SIZE, point.z() - POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() + POINT_SIZE, point.y() + POINT_SIZE, point.z() - POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() - POINT_SIZE, point.y() + POINT_SIZE, point.z() - POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() - POINT_SIZE, point.y() - POINT_SIZE, point.z() - POINT_SIZE));
-
-		actualPoints.push_back(Eigen::Vector3f(point.x() - POINT_SIZE, point.y() - POINT_SIZE, point.z() + POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() + POINT_SIZE, point.y() - POINT_SIZE, point.z() + POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() + POINT_SIZE, point.y() + POINT_SIZE, point.z() + POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() + POINT_SIZE, point.y() + POINT_SIZE, point.z() + POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() - POINT_SIZE, point.y() + POINT_SIZE, point.z() + POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() - POINT_SIZE, point.y() - POINT_SIZE, point.z() + POINT_SIZE));
-
-		actualPoints.push_back(Eigen::Vector3f(point.x() - POINT_SIZE, point.y() + POINT_SIZE, point.z() + POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() - POINT_SIZE, point.y() + POINT_SIZE, point.z() - POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() - POINT_SIZE, point.y() - POINT_SIZE, point.z() - POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() - POINT_SIZE, point.y() - POINT_SIZE, point.z() - POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() - POINT_SIZE, point.y() - POINT_SIZE, point.z() + POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() - POINT_SIZE, point.y() + POINT_SIZE, point.z() + POINT_SIZE));
-
-		actualPoints.push_back(Eigen::Vector3f(point.x() + POINT_SIZE, point.y() + POINT_SIZE, point.z() + POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() + POINT_SIZE, point.y() + POINT_SIZE, point.z() - POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() + POINT_SIZE, point.y() - POINT_SIZE, point.z() - POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() + POINT_SIZE, point.y() - POINT_SIZE, point.z() - POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() + POINT_SIZE, point.y() - POINT_SIZE, point.z() + POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() + POINT_SIZE, point.y() + POINT_SIZE, point.z() + POINT_SIZE));
-
-		actualPoints.push_back(Eigen::Vector3f(point.x() - POINT_SIZE, point.y() - POINT_SIZE, point.z() - POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() + POINT_SIZE, point.y() - POINT_SIZE, point.z() - POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() + POINT_SIZE, point.y() - POINT_SIZE, point.z() + POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() + POINT_SIZE, point.y() - POINT_SIZE, point.z() + POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() - POINT_SIZE, point.y() - POINT_SIZE, point.z() + POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() - POINT_SIZE, point.y() - POINT_SIZE, point.z() - POINT_SIZE));
-
-		actualPoints.push_back(Eigen::Vector3f(point.x() - POINT_SIZE, point.y() + POINT_SIZE, point.z() - POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() + POINT_SIZE, point.y() + POINT_SIZE, point.z() - POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() + POINT_SIZE, point.y() + POINT_SIZE, point.z() + POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() + POINT_SIZE, point.y() + POINT_SIZE, point.z() + POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() - POINT_SIZE, point.y() + POINT_SIZE, point.z() + POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() - POINT_SIZE, point.y() + POINT_SIZE, point.z() - POINT_SIZE));
-	}
-}
-
-void pointIndexConvertTriangle(
-	const std::vector<Eigen::Vector3f>& points, 
-	const std::vector<int>& pointIndexes,
-	std::vector<Eigen::Vector3f>& actualPoints) 
-{
-	for (int i = 0; i < pointIndexes.size(); i++) {
-		Eigen::Vector3f point = points[pointIndexes[i]];
-
-		actualPoints.push_back(Eigen::Vector3f(point.x() - POINT_SIZE, point.y() - POINT_SIZE, point.z() - POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() + POINT_SIZE, point.y() - POINT_SIZE, point.z() - POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() + POINT_SIZE, point.y() + POINT_SIZE, point.z() - POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() + POINT_SIZE, point.y() + POINT_SIZE, point.z() - POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() - POINT_SIZE, point.y() + POINT_SIZE, point.z() - POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() - POINT_SIZE, point.y() - POINT_SIZE, point.z() - POINT_SIZE));
-
-		actualPoints.push_back(Eigen::Vector3f(point.x() - POINT_SIZE, point.y() - POINT_SIZE, point.z() + POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() + POINT_SIZE, point.y() - POINT_SIZE, point.z() + POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() + POINT_SIZE, point.y() + POINT_SIZE, point.z() + POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() + POINT_SIZE, point.y() + POINT_SIZE, point.z() + POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() - POINT_SIZE, point.y() + POINT_SIZE, point.z() + POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() - POINT_SIZE, point.y() - POINT_SIZE, point.z() + POINT_SIZE));
-
-		actualPoints.push_back(Eigen::Vector3f(point.x() - POINT_SIZE, point.y() + POINT_SIZE, point.z() + POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() - POINT_SIZE, point.y() + POINT_SIZE, point.z() - POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() - POINT_SIZE, point.y() - POINT_SIZE, point.z() - POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() - POINT_SIZE, point.y() - POINT_SIZE, point.z() - POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() - POINT_SIZE, point.y() - POINT_SIZE, point.z() + POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() - POINT_SIZE, point.y() + POINT_SIZE, point.z() + POINT_SIZE));
-
-		actualPoints.push_back(Eigen::Vector3f(point.x() + POINT_SIZE, point.y() + POINT_SIZE, point.z() + POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() + POINT_SIZE, point.y() + POINT_SIZE, point.z() - POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() + POINT_SIZE, point.y() - POINT_SIZE, point.z() - POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() + POINT_SIZE, point.y() - POINT_SIZE, point.z() - POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() + POINT_SIZE, point.y() - POINT_SIZE, point.z() + POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() + POINT_SIZE, point.y() + POINT_SIZE, point.z() + POINT_SIZE));
-
-		actualPoints.push_back(Eigen::Vector3f(point.x() - POINT_SIZE, point.y() - POINT_SIZE, point.z() - POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() + POINT_SIZE, point.y() - POINT_SIZE, point.z() - POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() + POINT_SIZE, point.y() - POINT_SIZE, point.z() + POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() + POINT_SIZE, point.y() - POINT_SIZE, point.z() + POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() - POINT_SIZE, point.y() - POINT_SIZE, point.z() + POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() - POINT_SIZE, point.y() - POINT_SIZE, point.z() - POINT_SIZE));
-
-		actualPoints.push_back(Eigen::Vector3f(point.x() - POINT_SIZE, point.y() + POINT_SIZE, point.z() - POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() + POINT_SIZE, point.y() + POINT_SIZE, point.z() - POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() + POINT_SIZE, point.y() + POINT_SIZE, point.z() + POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() + POINT_SIZE, point.y() + POINT_SIZE, point.z() + POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() - POINT_SIZE, point.y() + POINT_SIZE, point.z() + POINT_SIZE));
-		actualPoints.push_back(Eigen::Vector3f(point.x() - POINT_SIZE, point.y() + POINT_SIZE, point.z() - POINT_SIZE));
+	vertices.clear();
+	for (int k = 0; k < 8; k++) {
+		vertices.push_back(Eigen::Vector3f(
+			k & 1 ? POINT_SIZE : -POINT_SIZE,
+			k & 2 ? POINT_SIZE : -POINT_SIZE,
+			k & 4 ? POINT_SIZE : -POINT_SIZE));
 	}
+	indices = {
+		0, 1, 3, 3, 2, 0,
+		4, 5, 7, 7, 6, 4,
+		6, 2, 0, 0, 4, 6,
+		7, 3, 1, 1, 5, 7,
+		0, 1, 5, 5, 4, 0,
+		2, 3, 7, 7, 6, 2
+	};
 }
 
 // жtargetstartendֱߵı
@@ -176,62 +104,134 @@ void SlowConvexHull(std::vector<Eigen::Vector3f> points, std::vector<Eigen::Vect
 	//std::cout << points.size() << ret.size();
 }
 
-// 㳯ջǳҹգ͹߽϶ǳҹ
-void ConvexHull(std::vector<Eigen::Vector3f> points, std::vector<Eigen::Vector3f>& retPoints) {
-	int n = points.size();
-	if (n <= 2) {
-		retPoints = points;
-		return;
-	}
-	std::vector<Eigen::Vector3f> upperHull, lowerHull;
-	// պС
-	sort(points.begin(), points.end(), [](const Eigen::Vector3f& p1, const Eigen::Vector3f& p2) {
-		return p1.x() < p2.x();
-	});
+// ȷķжϣ֮ǵĳ˻˫ûʱͼƬ꣩ȷ
+// 0ʱcabߣʱ룩С0ʱұߣ0ʱ㹲ߣԵά
+double orientation(const Eigen::Vector3f& a, const Eigen::Vector3f& b, const Eigen::Vector3f& c) {
+	double abx = static_cast<double>(b[0]) - a[0], aby = static_cast<double>(b[1]) - a[1];
+	double acx = static_cast<double>(c[0]) - a[0], acy = static_cast<double>(c[1]) - a[1];
+	return abx * acy - aby * acx;
+}
 
-	upperHull = { points[0], points[1] };
-	for (int i = 2; i < n; i++) {
-		// γתۣǳתĻмڵ
-		Eigen::Vector3f start, middle, end;
-		end = points[i];
-		while (upperHull.size() >= 2) {
-			start = upperHull[upperHull.size() - 2];
-			middle = upperHull.back();
-			if (pointSide(start, middle, end) < 0) {
-				upperHull.pop_back();
-			}
-			else {
-				break;
+// xyֵȽ
+bool lexicographicLess(const Eigen::Vector3f& p1, const Eigen::Vector3f& p2) {
+	return p1[0] < p2[0] || (p1[0] == p2[0] && p1[1] < p2[1]);
+}
+
+// AklCToussaintԤɸѡxyСĸɵıϸڲĵ㲻͹
+// ĵƵpointsǰ棬ĵ
+size_t aklToussaintFilter(std::span<Eigen::Vector3f> points) {
+	if (points.size() < 8) {
+		return points.size();
+	}
+	size_t left = 0, bottom = 0, right = 0, top = 0;
+	for (size_t i = 1; i < points.size(); i++) {
+		left = points[i][0] < points[left][0] ? i : left;
+		right = points[i][0] > points[right][0] ? i : right;
+		bottom = points[i][1] < points[bottom][1] ? i : bottom;
+		top = points[i][1] > points[top][1] ? i : top;
+	}
+	// ʱУغϵļʱı˻ûеϸڲ
+	const Eigen::Vector3f quad[4] = { points[left], points[bottom], points[right], points[top] };
+	auto outside = [&](const Eigen::Vector3f& p) {
+		for (int k = 0; k < 4; k++) {
+			if (orientation(quad[k], quad[(k + 1) % 4], p) <= 0) {
+				return true;
 			}
 		}
-		upperHull.push_back(points[i]);
-	}
+		return false;
+	};
+	return std::partition(points.begin(), points.end(), outside) - points.begin();
+}
 
-	lowerHull = { points[n - 1], points[n - 2] };
-	for (int i = n - 3; i >= 0; i--) {
-		Eigen::Vector3f start, middle, end;
-		end = points[i];
-		while (lowerHull.size() >= 2) {
-			start = lowerHull[lowerHull.size() - 2];
-			middle = lowerHull.back();
-			if (pointSide(start, middle, end) < 0) {
-				lowerHull.pop_back();
-			}
-			else {
-				break;
-			}
+// ԭصֵСĵLĵRڵֱ߰ĵΪ·ϣϷ֣
+// ·ֵϷкɨһ飬ĵ뵱ǰ㽻͹pointsǰ׺
+// ͹ĵ͹ʱУLʼߵĵظĵ
+size_t monotoneChainInPlace(std::span<Eigen::Vector3f> points) {
+	size_t n = points.size();
+	if (n == 0) {
+		return 0;
+	}
+	auto [minIt, maxIt] = std::minmax_element(points.begin(), points.end(), lexicographicLess);
+	size_t left = minIt - points.begin(), right = maxIt - points.begin();
+	if (!lexicographicLess(points[left], points[right])) {
+		// еغ
+		return 1;
+	}
+	std::swap(points[0], points[left]);
+	if (right == 0) {
+		right = left;
+	}
+	std::swap(points[n - 1], points[right]);
+	const Eigen::Vector3f L = points[0], R = points[n - 1];
+	auto middle = std::partition(points.begin() + 1, points.end() - 1, [&](const Eigen::Vector3f& p) {
+		return orientation(L, R, p) <= 0;
+	});
+	// R·Ϸĵ֮
+	std::iter_swap(middle, points.end() - 1);
+	std::sort(points.begin() + 1, middle, lexicographicLess);
+	std::sort(middle + 1, points.end(), [](const Eigen::Vector3f& p1, const Eigen::Vector3f& p2) {
+		return lexicographicLess(p2, p1);
+	});
+	// ͹ǴLR͹ǴRصLǳյĵ㶼
+	size_t k = 0;
+	for (size_t i = 0; i < n; i++) {
+		while (k >= 2 && orientation(points[k - 2], points[k - 1], points[i]) <= 0) {
+			k--;
 		}
-		lowerHull.push_back(points[i]);
+		std::swap(points[k++], points[i]);
 	}
+	// βӴLߵĵ
+	while (k >= 3 && orientation(points[k - 2], points[k - 1], points[0]) <= 0) {
+		k--;
+	}
+	return k;
+}
 
-	// βӣСĵ϶͹߽
-	retPoints = upperHull;
-	for (int i = 0; i < lowerHull.size(); i++) {
-		if (i != 0 && i != lowerHull.size() - 1) {
-			retPoints.push_back(lowerHull[i]);
+// ڵߵĵԭ͹͹ʱpointsǰ׺У͹ĵĵ˳
+// CONVEX_HULL_CHUNKʱֿ鲢УֱԤɸѡ͹ٶԸ͹Ĳ͹hullSizes¼͹ĵ֡ظʹ
+size_t ConvexHullInPlace(std::span<Eigen::Vector3f> points, std::vector<size_t>& hullSizes) {
+	size_t n = points.size();
+	int chunkNum = (n + CONVEX_HULL_CHUNK - 1) / CONVEX_HULL_CHUNK;
+	if (chunkNum <= 1) {
+		return monotoneChainInPlace(points.first(aklToussaintFilter(points)));
+	}
+	hullSizes.resize(chunkNum);
+#pragma omp parallel for schedule(dynamic)
+	for (int c = 0; c < chunkNum; c++) {
+		std::span<Eigen::Vector3f> chunk = points.subspan(static_cast<size_t>(c) * CONVEX_HULL_CHUNK, std::min<size_t>(CONVEX_HULL_CHUNK, n - static_cast<size_t>(c) * CONVEX_HULL_CHUNK));
+		hullSizes[c] = monotoneChainInPlace(chunk.first(aklToussaintFilter(chunk)));
+	}
+	// ͹Ƶǰ
+	size_t total = 0;
+	for (int c = 0; c < chunkNum; c++) {
+		for (size_t i = 0; i < hullSizes[c]; i++) {
+			std::swap(points[total++], points[static_cast<size_t>(c) * CONVEX_HULL_CHUNK + i]);
 		}
 	}
-	//std::cout << points.size() << retPoints.size();
+	return monotoneChainInPlace(points.first(total));
+}
+
+size_t ConvexHullInPlace(std::span<Eigen::Vector3f> points) {
+	std::vector<size_t> hullSizes;
+	return ConvexHullInPlace(points, hullSizes);
+}
+
+// һݵԭ͹
+void ConvexHull(const std::vector<Eigen::Vector3f>& points, std::vector<Eigen::Vector3f>& retPoints) {
+	retPoints = points;
+	retPoints.resize(ConvexHullInPlace(retPoints));
+}
+
+// İΧ(x0, y0, x1, y1)͹㼴ɣûеʱx0 > x1
+Eigen::Vector4f pointBounds(std::span<const Eigen::Vector3f> points) {
+	Eigen::Vector4f bounds(FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX);
+	for (const auto& point : points) {
+		bounds[0] = std::min(bounds[0], point[0]);
+		bounds[1] = std::min(bounds[1], point[1]);
+		bounds[2] = std::max(bounds[2], point[0]);
+		bounds[3] = std::max(bounds[3], point[1]);
+	}
+	return bounds;
 }
 
 float eh(const Eigen::Vector3f& p1, const Eigen::Vector3f& p2) {
@@ -244,38 +244,116 @@ void circleCenterCalc(const Eigen::Vector3f& p1, const Eigen::Vector3f& p2, Eige
 	c2 = { (p1[0] + p2[0]) / 2 + ehValue * (p1[1] - p2[1]), (p1[1] + p2[1]) / 2 + ehValue * (p2[0] - p1[0]), 0.0f };
 }
 
-void ConcaveHull(const std::vector<Eigen::Vector3f>& points, std::vector<int>& retPointIndexes, std::vector<std::pair<int, int>>& retEdgeIndexes) {
+// ʱʹõĻ壬֡ظʹʱٷڴ
+struct ConcaveHullScratch {
+	std::vector<std::vector<int>> candPoints;
+	std::vector<int> pointCells;
+	std::vector<int> cellStart;
+	std::vector<int> cellCursor;
+	std::vector<int> cellPoints;
+	std::vector<int> edgeOffsets;
+	std::vector<char> edgeFlags;
+};
+
+// -shapeƽСALPHA * 2ĵΪѡߣѡ߶˵㡢뾶ΪALPHAԲһѡʱΪ߽
+// ѡñ߳Ϊsqrt(ALPHA * 2)ľңÿֻΧ3  3ӣѡ߰㲢жϣ˳˳һ
+void ConcaveHull(const std::vector<Eigen::Vector3f>& points, std::vector<int>& retPointIndexes, std::vector<std::pair<int, int>>& retEdgeIndexes, ConcaveHullScratch& scratch) {
 	int n = points.size();
-	std::vector<std::vector<int>> candPoints(n);
+	if (n == 0) {
+		return;
+	}
+	// ֻʱÿѡб
+	auto& candPoints = scratch.candPoints;
+	if (static_cast<int>(candPoints.size()) < n) {
+		candPoints.resize(n);
+	}
+	// Դںѡ룬©ڸ֮ĺѡ
+	const float cellSize = std::sqrt(ALPHA * 2) * 1.001f;
+	float minX = points[0][0], maxX = minX, minY = points[0][1], maxY = minY;
+	for (const auto& point : points) {
+		minX = std::min(minX, point[0]);
+		maxX = std::max(maxX, point[0]);
+		minY = std::min(minY, point[1]);
+		maxY = std::max(maxY, point[1]);
+	}
+	int xCells = static_cast<int>((maxX - minX) / cellSize) + 1;
+	int yCells = static_cast<int>((maxY - minY) / cellSize) + 1;
+	// Ӽͬһڵĵ㱣ԭ˳
+	auto& pointCells = scratch.pointCells;
+	auto& cellStart = scratch.cellStart;
+	auto& cellCursor = scratch.cellCursor;
+	auto& cellPoints = scratch.cellPoints;
+	pointCells.resize(n);
+	cellStart.assign(xCells * yCells + 1, 0);
+	for (int i = 0; i < n; i++) {
+		int cx = static_cast<int>((points[i][0] - minX) / cellSize);
+		int cy = static_cast<int>((points[i][1] - minY) / cellSize);
+		pointCells[i] = std::min(cx, xCells - 1) * yCells + std::min(cy, yCells - 1);
+		cellStart[pointCells[i] + 1]++;
+	}
+	for (int cell = 0; cell < xCells * yCells; cell++) {
+		cellStart[cell + 1] += cellStart[cell];
+	}
+	cellCursor.assign(cellStart.begin(), cellStart.end() - 1);
+	cellPoints.resize(n);
+	for (int i = 0; i < n; i++) {
+		cellPoints[cellCursor[pointCells[i]]++] = i;
+	}
+#pragma omp parallel for schedule(dynamic, 256)
 	for (int i = 0; i < n; i++) {
-		for (int j = i + 1; j < n; j++) {
-			float squaredDistance = (points[i] - points[j]).squaredNorm();
-			if (squaredDistance < ALPHA * 2) {
-				candPoints[i].push_back(j);
-				candPoints[j].push_back(i);
+		auto& candidates = candPoints[i];
+		candidates.clear();
+		int cx = pointCells[i] / yCells, cy = pointCells[i] % yCells;
+		for (int x = std::max(cx - 1, 0); x <= std::min(cx + 1, xCells - 1); x++) {
+			for (int y = std::max(cy - 1, 0); y <= std::min(cy + 1, yCells - 1); y++) {
+				int cell = x * yCells + y;
+				for (int c = cellStart[cell]; c < cellStart[cell + 1]; c++) {
+					int j = cellPoints[c];
+					if (j != i && (points[i] - points[j]).squaredNorm() < ALPHA * 2) {
+						candidates.push_back(j);
+					}
+				}
 			}
 		}
+		std::sort(candidates.begin(), candidates.end());
 	}
-	for (int i = 0; i < points.size(); i++) {
-		for (int j = 0; j < candPoints[i].size(); j++) {
-			if (candPoints[i][j] <= i) {
+	// edgeFlags[edgeOffsets[i] + j]¼ѡ(i, candPoints[i][j])ǷΪ߽
+	auto& edgeOffsets = scratch.edgeOffsets;
+	auto& edgeFlags = scratch.edgeFlags;
+	edgeOffsets.resize(n + 1);
+	edgeOffsets[0] = 0;
+	for (int i = 0; i < n; i++) {
+		edgeOffsets[i + 1] = edgeOffsets[i] + candPoints[i].size();
+	}
+	edgeFlags.assign(edgeOffsets[n], 0);
+	const float squaredAlpha = ALPHA * ALPHA;
+#pragma omp parallel for schedule(dynamic, 256)
+	for (int i = 0; i < n; i++) {
+		const auto& candidates = candPoints[i];
+		for (int j = 0; j < candidates.size(); j++) {
+			if (candidates[j] <= i) {
 				continue;
 			}
 			Eigen::Vector3f c1, c2;
-			circleCenterCalc(points[i], points[candPoints[i][j]], c1, c2);
+			circleCenterCalc(points[i], points[candidates[j]], c1, c2);
 			bool flag1 = true, flag2 = true;
-			for (int k = 0; k < candPoints[i].size(); k++) {
-				if (candPoints[i][k] != candPoints[i][j]) {
-					if ((c1 - points[candPoints[i][k]]).norm() <= ALPHA) {
+			for (int k = 0; k < candidates.size() && (flag1 || flag2); k++) {
+				if (candidates[k] != candidates[j]) {
+					if ((c1 - points[candidates[k]]).squaredNorm() <= squaredAlpha) {
 						flag1 = false;
 					}
-					if ((c2 - points[candPoints[i][k]]).norm() <= ALPHA) {
+					if ((c2 - points[candidates[k]]).squaredNorm() <= squaredAlpha) {
 						flag2 = false;
 					}
 				}
 			}
-			// ʱpoints[i]points[candPoints[i][j]]ɰ߽
-			if (flag1 || flag2) {
+			// ʱpoints[i]points[candidates[j]]ɰ߽
+			edgeFlags[edgeOffsets[i] + j] = flag1 || flag2;
+		}
+	}
+	for (int i = 0; i < n; i++) {
+		for (int j = 0; j < candPoints[i].size(); j++) {
+			if (edgeFlags[edgeOffsets[i] + j]) {
 				retPointIndexes.emplace_back(i);
 				retEdgeIndexes.emplace_back(std::make_pair(i, candPoints[i][j]));
 			}
@@ -283,4 +361,176 @@ void ConcaveHull(const std::vector<Eigen::Vector3f>& points, std::vector<int>& r
 	}
 }
 
+void ConcaveHull(const std::vector<Eigen::Vector3f>& points, std::vector<int>& retPointIndexes, std::vector<std::pair<int, int>>& retEdgeIndexes) {
+	ConcaveHullScratch scratch;
+	ConcaveHull(points, retPointIndexes, retEdgeIndexes, scratch);
+}
+
+// DelaunayʷϵĦ-shapeԦΪ뾶˵ڲԲʱñΪ߽
+// ı߶DelaunayߣԲİ뾶һ[alphaMin, alphaMax]alphaMaxΪԲ뾶Ľϴߣ͹Ϊ󣩣
+// ĶԶ㶼ԸñΪֱԲʱalphaMinΪ߳һ룬ΪԲ뾶ĽС
+// ConcaveHull()ͬ߳ƽСڦ * 2ı߲Ϊ߽磬alphaMinСڱ߳ƽһ룬˦ = ALPHAʱĽConcaveHull()һ£
+// ConcaveHull()ֻþpoints[i]Сsqrt(ALPHA * 2)ĵжԲǷΪգеĵ㣬ԲиԶĵʱConcaveHull()Իñ
+// ʷֺֻbuild()мһΣO(n log n)extract()ֻһɸѡ
+struct AlphaEdge {
+	int first, second;
+	float alphaMin, alphaMax;
+};
+
+// cv::Subdiv2D::getLeadingEdgeList()ÿεö飬ֱӱıαߣɵṩظʹ
+class DelaunaySubdivision : public cv::Subdiv2D {
+public:
+	// ÿΣⲿģ¼һߣgetLeadingEdgeList()Ľͬ
+	void getLeadingEdges(std::vector<int>& leadingEdges, std::vector<char>& edgeMask) const {
+		leadingEdges.clear();
+		int total = static_cast<int>(qedges.size()) * 4;
+		edgeMask.assign(total, 0);
+		for (int i = 4; i < total; i += 2) {
+			if (edgeMask[i] || qedges[i >> 2].isfree()) {
+				continue;
+			}
+			int edge = i;
+			edgeMask[edge] = 1;
+			edge = getEdge(edge, NEXT_AROUND_LEFT);
+			edgeMask[edge] = 1;
+			edge = getEdge(edge, NEXT_AROUND_LEFT);
+			edgeMask[edge] = 1;
+			leadingEdges.push_back(i);
+		}
+	}
+};
+
+class AlphaShape {
+public:
+	// cv::Subdiv2DDelaunayʷ֣ظĵֻһ
+	// ʷֺеĻ嶼ǳԱ֡ظʹã֮ǰֵʱٷڴ
+	void build(const std::vector<Eigen::Vector3f>& points) {
+		edges.clear();
+		triangles.clear();
+		int n = points.size();
+		if (n < 3) {
+			return;
+		}
+		float minX = points[0][0], maxX = minX, minY = points[0][1], maxY = minY;
+		for (const auto& point : points) {
+			minX = std::min(minX, point[0]);
+			maxX = std::max(maxX, point[0]);
+			minY = std::min(minY, point[1]);
+			maxY = std::max(maxY, point[1]);
+		}
+		int x0 = static_cast<int>(std::floor(minX)) - 1, y0 = static_cast<int>(std::floor(minY)) - 1;
+		subdiv.initDelaunay(cv::Rect(x0, y0, static_cast<int>(std::ceil(maxX)) - x0 + 2, static_cast<int>(std::ceil(maxY)) - y0 + 2));
+		// Subdiv2Dǰ4Ϊⲿ㣬֮ĶŶӦĵ
+		vertexPoints.assign(n + 4, -1);
+		for (int i = 0; i < n; i++) {
+			int vertex = subdiv.insert(cv::Point2f(points[i][0], points[i][1]));
+			if (vertex >= 0 && vertex < static_cast<int>(vertexPoints.size()) && vertexPoints[vertex] < 0) {
+				vertexPoints[vertex] = i;
+			}
+		}
+		subdiv.getLeadingEdges(leadingEdges, edgeMask);
+		for (int edge : leadingEdges) {
+			int e1 = subdiv.getEdge(edge, cv::Subdiv2D::NEXT_AROUND_LEFT);
+			int e2 = subdiv.getEdge(e1, cv::Subdiv2D::NEXT_AROUND_LEFT);
+			if (subdiv.getEdge(e2, cv::Subdiv2D::NEXT_AROUND_LEFT) != edge) {
+				continue;
+			}
+			int v[3] = { subdiv.edgeOrg(edge), subdiv.edgeOrg(e1), subdiv.edgeOrg(e2) };
+			bool inner = true;
+			for (int k = 0; k < 3; k++) {
+				inner = inner && v[k] >= 4 && v[k] < static_cast<int>(vertexPoints.size()) && vertexPoints[v[k]] >= 0;
+			}
+			if (inner) {
+				triangles.push_back({ vertexPoints[v[0]], vertexPoints[v[1]], vertexPoints[v[2]] });
+			}
+		}
+		buildFromTriangles(points, triangles);
+	}
+
+	// DelaunayμÿߵĦ
+	void buildFromTriangles(const std::vector<Eigen::Vector3f>& points, const std::vector<std::array<int, 3>>& triangles) {
+		// ÿεÿ߼¼һ˵㣨first < secondԲ뾶ͶԶ㣬˵ͬһߵ
+		entries.clear();
+		for (const auto& triangle : triangles) {
+			float radius = circumradius(points[triangle[0]], points[triangle[1]], points[triangle[2]]);
+			for (int k = 0; k < 3; k++) {
+				int a = triangle[k], b = triangle[(k + 1) % 3];
+				entries.push_back({ std::min(a, b), std::max(a, b), radius, triangle[(k + 2) % 3] });
+			}
+		}
+		std::sort(entries.begin(), entries.end(), [](const EdgeEntry& e1, const EdgeEntry& e2) {
+			return e1.first != e2.first ? e1.first < e2.first : e1.second < e2.second;
+		});
+		edges.clear();
+		for (size_t e = 0; e < entries.size();) {
+			size_t end = e + 1;
+			while (end < entries.size() && entries[end].first == entries[e].first && entries[end].second == entries[e].second) {
+				end++;
+			}
+			const Eigen::Vector3f& p = points[entries[e].first];
+			const Eigen::Vector3f& q = points[entries[e].second];
+			float radiusMin = FLT_MAX, radiusMax = 0.0f;
+			bool gabriel = true;
+			for (size_t k = e; k < end; k++) {
+				radiusMin = std::min(radiusMin, entries[k].radius);
+				radiusMax = std::max(radiusMax, entries[k].radius);
+				const Eigen::Vector3f& o = points[entries[k].opposite];
+				// Զ㴦Ϊ۽ʱԶԸñΪֱԲ
+				if ((p[0] - o[0]) * (q[0] - o[0]) + (p[1] - o[1]) * (q[1] - o[1]) < 0.0f) {
+					gabriel = false;
+				}
+			}
+			float squaredLength = (p[0] - q[0]) * (p[0] - q[0]) + (p[1] - q[1]) * (p[1] - q[1]);
+			float alphaMin = std::max(gabriel ? 0.5f * std::sqrt(squaredLength) : radiusMin, 0.5f * squaredLength);
+			float alphaMax = end - e >= 2 ? radiusMax : FLT_MAX;
+			// Ϊյı߶κΦǱ߽磬
+			if (alphaMin < alphaMax) {
+				edges.push_back({ entries[e].first, entries[e].second, alphaMin, alphaMax });
+			}
+			e = end;
+		}
+	}
+
+	// 뾶Ϊalphaʱİ߽磬ConcaveHull()ʽͬһ˵㡢ڶ˵
+	void extract(float alpha, std::vector<int>& retPointIndexes, std::vector<std::pair<int, int>>& retEdgeIndexes) const {
+		for (const auto& edge : edges) {
+			if (edge.alphaMin <= alpha && alpha < edge.alphaMax) {
+				retPointIndexes.emplace_back(edge.first);
+				retEdgeIndexes.emplace_back(edge.first, edge.second);
+			}
+		}
+	}
+
+	const std::vector<AlphaEdge>& getEdges() const {
+		return edges;
+	}
+
+private:
+	struct EdgeEntry {
+		int first, second;
+		float radius;
+		int opposite;
+	};
+
+	DelaunaySubdivision subdiv;
+	std::vector<AlphaEdge> edges;
+	std::vector<std::array<int, 3>> triangles;
+	std::vector<EdgeEntry> entries;
+	std::vector<int> vertexPoints;
+	std::vector<int> leadingEdges;
+	std::vector<char> edgeMask;
+
+	// ˻ΰ뾶Ϊ󣬲κΦİڲ
+	static float circumradius(const Eigen::Vector3f& a, const Eigen::Vector3f& b, const Eigen::Vector3f& c) {
+		double abx = b[0] - a[0], aby = b[1] - a[1];
+		double acx = c[0] - a[0], acy = c[1] - a[1];
+		double cross = abx * acy - aby * acx;
+		if (std::fabs(cross) < 1e-12) {
+			return FLT_MAX;
+		}
+		double ab = std::hypot(abx, aby), ac = std::hypot(acx, acy), bc = std::hypot(c[0] - b[0], c[1] - b[1]);
+		return static_cast<float>(std::min(ab * ac * bc / (2.0 * std::fabs(cross)), static_cast<double>(FLT_MAX)));
+	}
+};
+
 #endif
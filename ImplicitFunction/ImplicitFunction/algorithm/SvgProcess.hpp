@@ -0,0 +1,484 @@
+#ifndef __SVG_PROCESS_HPP__
+#define __SVG_PROCESS_HPP__
+
+#define SVG_FLATNESS 0.05f
+#define SVG_MAX_DEPTH 16
+#include "../algorithm/ImageProcess.hpp"
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// һֱ߻BzierߣorderΪ123ʱֱpoints[0..order]ΪƵ
+struct SvgSegment {
+	int order;
+	Eigen::Vector2f points[4];
+
+	Eigen::Vector2f point(float t) const {
+		float s = 1.0f - t;
+		if (order == 1) {
+			return s * points[0] + t * points[1];
+		}
+		if (order == 2) {
+			return s * s * points[0] + 2.0f * s * t * points[1] + t * t * points[2];
+		}
+		return s * s * s * points[0] + 3.0f * s * s * t * points[1] + 3.0f * s * t * t * points[2] + t * t * t * points[3];
+	}
+
+	// tĵ߷
+	Eigen::Vector2f derivative(float t) const {
+		float s = 1.0f - t;
+		if (order == 1) {
+			return points[1] - points[0];
+		}
+		if (order == 2) {
+			return 2.0f * s * (points[1] - points[0]) + 2.0f * t * (points[2] - points[1]);
+		}
+		return 3.0f * s * s * (points[1] - points[0]) + 6.0f * s * t * (points[2] - points[1]) + 3.0f * t * t * (points[3] - points[2]);
+	}
+};
+
+// һպϵ·SVGʱδպϵ·Ҳպϴ
+struct SvgSubpath {
+	std::vector<SvgSegment> segments;
+};
+
+// չƽ߶㣺λԼڵ߶κͲ
+struct SvgVertex {
+	Eigen::Vector2f position;
+	int segment;
+	float t;
+};
+
+// ļչΪ.svgʱSVG·ȡ
+bool isSvgPath(const char* path) {
+	std::string name(path);
+	if (name.size() < 4) {
+		return false;
+	}
+	std::string extension = name.substr(name.size() - 4);
+	std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return tolower(c); });
+	return extension == ".svg";
+}
+
+// SVG·е֣֧"-1.5e2"".5.5"ʡԷָд
+bool svgNumber(const std::string& data, size_t& pos, float& value) {
+	while (pos < data.size() && (isspace(static_cast<unsigned char>(data[pos])) || data[pos] == ',')) {
+		pos++;
+	}
+	if (pos >= data.size()) {
+		return false;
+	}
+	const char* begin = data.c_str() + pos;
+	char* end = nullptr;
+	value = strtof(begin, &end);
+	if (end == begin) {
+		return false;
+	}
+	pos += end - begin;
+	return true;
+}
+
+// SVG·ݣM/L/H/V/Q/T/C/S/ZСдʽֵ֧ԲAʱfalse
+bool parseSvgPath(const std::string& data, std::vector<SvgSubpath>& subpaths) {
+	Eigen::Vector2f current(0.0f, 0.0f), start(0.0f, 0.0f), lastControl(0.0f, 0.0f);
+	char command = 0, previous = 0;
+	size_t pos = 0;
+	auto closeSubpath = [&]() {
+		if (!subpaths.empty() && !subpaths.back().segments.empty() && current != start) {
+			subpaths.back().segments.push_back({ 1, { current, start } });
+		}
+		current = start;
+	};
+	while (true) {
+		while (pos < data.size() && (isspace(static_cast<unsigned char>(data[pos])) || data[pos] == ',')) {
+			pos++;
+		}
+		if (pos >= data.size()) {
+			break;
+		}
+		if (isalpha(static_cast<unsigned char>(data[pos]))) {
+			command = data[pos++];
+		}
+		else if (command == 0) {
+			return false;
+		}
+		bool relative = islower(static_cast<unsigned char>(command));
+		Eigen::Vector2f origin = relative ? current : Eigen::Vector2f(0.0f, 0.0f);
+		float v[6];
+		auto readNumbers = [&](int count) {
+			for (int i = 0; i < count; i++) {
+				if (!svgNumber(data, pos, v[i])) {
+					return false;
+				}
+			}
+			return true;
+		};
+		char upper = toupper(static_cast<unsigned char>(command));
+		// ·ݱMʼ
+		if (upper != 'M' && subpaths.empty()) {
+			return false;
+		}
+		// κߵķƵֻһͬʱЧ
+		bool previousQuadratic = previous == 'Q' || previous == 'T';
+		bool previousCubic = previous == 'C' || previous == 'S';
+		switch (upper) {
+		case 'M':
+			if (!readNumbers(2)) {
+				return false;
+			}
+			closeSubpath();
+			current = start = origin + Eigen::Vector2f(v[0], v[1]);
+			subpaths.emplace_back();
+			// M֮԰L
+			command = relative ? 'l' : 'L';
+			break;
+		case 'L':
+		case 'H':
+		case 'V': {
+			if (!readNumbers(upper == 'L' ? 2 : 1)) {
+				return false;
+			}
+			Eigen::Vector2f next = upper == 'L' ? origin + Eigen::Vector2f(v[0], v[1])
+				: upper == 'H' ? Eigen::Vector2f(origin.x() + v[0], current.y())
+				: Eigen::Vector2f(current.x(), origin.y() + v[0]);
+			if (next != current) {
+				subpaths.back().segments.push_back({ 1, { current, next } });
+			}
+			current = next;
+			break;
+		}
+		case 'Q':
+		case 'T': {
+			if (!readNumbers(upper == 'Q' ? 4 : 2)) {
+				return false;
+			}
+			Eigen::Vector2f control = upper == 'Q' ? origin + Eigen::Vector2f(v[0], v[1])
+				: previousQuadratic ? 2.0f * current - lastControl : current;
+			Eigen::Vector2f next = upper == 'Q' ? origin + Eigen::Vector2f(v[2], v[3]) : origin + Eigen::Vector2f(v[0], v[1]);
+			subpaths.back().segments.push_back({ 2, { current, control, next } });
+			lastControl = control;
+			current = next;
+			break;
+		}
+		case 'C':
+		case 'S': {
+			if (!readNumbers(upper == 'C' ? 6 : 4)) {
+				return false;
+			}
+			int k = upper == 'C' ? 2 : 0;
+			Eigen::Vector2f control1 = upper == 'C' ? origin + Eigen::Vector2f(v[0], v[1])
+				: previousCubic ? 2.0f * current - lastControl : current;
+			Eigen::Vector2f control2 = origin + Eigen::Vector2f(v[k], v[k + 1]);
+			Eigen::Vector2f next = origin + Eigen::Vector2f(v[k + 2], v[k + 3]);
+			subpaths.back().segments.push_back({ 3, { current, control1, control2, next } });
+			lastControl = control2;
+			current = next;
+			break;
+		}
+		case 'Z':
+			closeSubpath();
+			command = 0;
+			break;
+		default:
+			std::cerr << "Unsupported SVG path command: " << command << std::endl;
+			return false;
+		}
+		previous = upper;
+	}
+	closeSubpath();
+	return true;
+}
+
+// ȡSVGļеֵûʱؿַ
+std::string svgAttribute(const std::string& element, const char* name) {
+	std::string key = std::string(" ") + name + "=";
+	size_t pos = element.find(key);
+	if (pos == std::string::npos) {
+		return "";
+	}
+	pos += key.size();
+	char quote = element[pos];
+	size_t end = element.find(quote, pos + 1);
+	return end == std::string::npos ? "" : element.substr(pos + 1, end - pos - 1);
+}
+
+// ȡSVGļ<svg>widthheightviewBoxͼƬС<path>dԺϲΪһ״
+// ·꾭viewBoxΪ֧꣬transform
+bool readSvgFile(const char* svgPath, int& rows, int& cols, std::vector<SvgSubpath>& subpaths) {
+	std::ifstream file(svgPath);
+	if (!file) {
+		return false;
+	}
+	std::stringstream buffer;
+	buffer << file.rdbuf();
+	std::string text = buffer.str();
+	for (char& c : text) {
+		if (c == '\n' || c == '\r' || c == '\t') {
+			c = ' ';
+		}
+	}
+	size_t svgBegin = text.find("<svg");
+	if (svgBegin == std::string::npos) {
+		return false;
+	}
+	std::string svgElement = text.substr(svgBegin, text.find('>', svgBegin) - svgBegin);
+	float viewBox[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	std::string viewBoxText = svgAttribute(svgElement, "viewBox");
+	size_t pos = 0;
+	for (int i = 0; i < 4 && !viewBoxText.empty(); i++) {
+		if (!svgNumber(viewBoxText, pos, viewBox[i])) {
+			return false;
+		}
+	}
+	// widthheightĵλֻ֧أȱʡʱȡviewBoxĴС
+	float width = strtof(svgAttribute(svgElement, "width").c_str(), nullptr);
+	float height = strtof(svgAttribute(svgElement, "height").c_str(), nullptr);
+	width = width > 0.0f ? width : viewBox[2];
+	height = height > 0.0f ? height : viewBox[3];
+	if (width <= 0.0f || height <= 0.0f) {
+		std::cerr << "SVG size is missing: " << svgPath << std::endl;
+		return false;
+	}
+	cols = static_cast<int>(std::ceil(width));
+	rows = static_cast<int>(std::ceil(height));
+	Eigen::Vector2f scale(1.0f, 1.0f), offset(0.0f, 0.0f);
+	if (viewBox[2] > 0.0f && viewBox[3] > 0.0f) {
+		scale = Eigen::Vector2f(width / viewBox[2], height / viewBox[3]);
+		offset = Eigen::Vector2f(viewBox[0], viewBox[1]);
+	}
+
+	for (size_t begin = text.find("<path"); begin != std::string::npos; begin = text.find("<path", begin + 1)) {
+		std::string element = text.substr(begin, text.find('>', begin) - begin);
+		std::string data = svgAttribute(element, "d");
+		size_t first = subpaths.size();
+		if (!parseSvgPath(data, subpaths)) {
+			std::cerr << "Failed to parse SVG path: " << svgPath << std::endl;
+			return false;
+		}
+		for (size_t i = first; i < subpaths.size(); i++) {
+			for (auto& segment : subpaths[i].segments) {
+				for (int k = 0; k <= segment.order; k++) {
+					segment.points[k] = (segment.points[k] - offset).cwiseProduct(scale);
+				}
+			}
+		}
+	}
+	subpaths.erase(std::remove_if(subpaths.begin(), subpaths.end(), [](const SvgSubpath& subpath) {
+		return subpath.segments.empty();
+	}), subpaths.end());
+	return !subpaths.empty();
+}
+
+// Ӧչƽ[t0, t1]еķֵ㵽ҵľ붼SVG_FLATNESSʱҴ棬
+void flattenSegment(const SvgSegment& segment, int index, float t0, float t1, int depth, std::vector<SvgVertex>& vertices) {
+	Eigen::Vector2f a = segment.point(t0), b = segment.point(t1);
+	bool flat = segment.order == 1 || depth >= SVG_MAX_DEPTH;
+	if (!flat) {
+		flat = true;
+		for (float f : { 0.25f, 0.5f, 0.75f }) {
+			if (segmentDistance(segment.point(t0 + (t1 - t0) * f), a, b) > SVG_FLATNESS) {
+				flat = false;
+				break;
+			}
+		}
+	}
+	if (flat) {
+		vertices.push_back({ b, index, t1 });
+		return;
+	}
+	float middle = (t0 + t1) * 0.5f;
+	flattenSegment(segment, index, t0, middle, depth + 1, vertices);
+	flattenSegment(segment, index, middle, t1, depth + 1, vertices);
+}
+
+// ·չƽΪպߣ׸Ϊһε㣬һ׸غʱȥ
+void flattenSubpath(const SvgSubpath& subpath, std::vector<SvgVertex>& vertices) {
+	vertices.clear();
+	vertices.push_back({ subpath.segments[0].points[0], 0, 0.0f });
+	for (int i = 0; i < subpath.segments.size(); i++) {
+		flattenSegment(subpath.segments[i], i, 0.0f, 1.0f, 0, vertices);
+	}
+	if (vertices.size() > 1 && vertices.back().position == vertices.front().position) {
+		vertices.pop_back();
+	}
+}
+
+// żжϵǷڱպ
+bool insidePolyline(const std::vector<Eigen::Vector2f>& polyline, const Eigen::Vector2f& point) {
+	bool inside = false;
+	int n = polyline.size();
+	for (int i = 0, j = n - 1; i < n; j = i++) {
+		const Eigen::Vector2f& a = polyline[i];
+		const Eigen::Vector2f& b = polyline[j];
+		if ((a.y() > point.y()) != (b.y() > point.y())
+			&& point.x() < (b.x() - a.x()) * (point.y() - a.y()) / (b.y() - a.y()) + a.x()) {
+			inside = !inside;
+		}
+	}
+	return inside;
+}
+
+// SVG·룺դ񻯺ͱԵ⣬ֱȡ߽Լ㣬ߵĵ
+// ÿ·ڲ䷽Ƕײż򣺱ż·ʱΪ߽磬ʱΪף
+// 㰴ָ·ÿλúͷԭϼ㣬չƽֻȷǶ׹ϵ
+bool processSvg(
+	const char* svgPath,
+	int& rows, int& cols,
+	std::vector<Eigen::Vector2f>& boundaryPoints,
+	std::vector<Eigen::Vector2f>& normalPoints)
+{
+	std::vector<SvgSubpath> subpaths;
+	if (!readSvgFile(svgPath, rows, cols, subpaths)) {
+		std::cerr << "Failed to read " << svgPath << std::endl;
+		return false;
+	}
+	int m = subpaths.size();
+	std::vector<std::vector<SvgVertex>> vertices(m);
+	std::vector<std::vector<Eigen::Vector2f>> polylines(m);
+	std::vector<float> lengths(m, 0.0f);
+	float totalLength = 0.0f;
+	for (int s = 0; s < m; s++) {
+		flattenSubpath(subpaths[s], vertices[s]);
+		for (const auto& vertex : vertices[s]) {
+			polylines[s].push_back(vertex.position);
+		}
+		for (int i = 0; i < polylines[s].size(); i++) {
+			lengths[s] += (polylines[s][(i + 1) % polylines[s].size()] - polylines[s][i]).norm();
+		}
+		totalLength += lengths[s];
+	}
+#ifdef RESAMPLE_MODE
+	int sampleNum = (MAX_MATRIX_DIMENSION - DIMENSION - 1) / 2;
+#else
+	int sampleNum = SAMPLE_NUM;
+#endif // RESAMPLE_MODE
+
+	// ·Ĳ䣬ÿ3ܳsampleNumԼࣩ
+	// ʱӵ·мȥ·̫ࡢÿ3ҲŲʱ̵·
+	std::vector<int> shares(m, 0);
+	int total = 0, ignored = 0;
+	for (int s = 0; s < m; s++) {
+		if (polylines[s].size() >= 3 && lengths[s] > 0.0f) {
+			shares[s] = std::max(3, static_cast<int>(std::lround(sampleNum * lengths[s] / totalLength)));
+			total += shares[s];
+		}
+	}
+	while (total > sampleNum) {
+		int largest = std::max_element(shares.begin(), shares.end()) - shares.begin();
+		if (shares[largest] > 3) {
+			shares[largest]--;
+			total--;
+			continue;
+		}
+		int shortest = -1;
+		for (int s = 0; s < m; s++) {
+			if (shares[s] > 0 && (shortest < 0 || lengths[s] < lengths[shortest])) {
+				shortest = s;
+			}
+		}
+		total -= shares[shortest];
+		shares[shortest] = 0;
+		ignored++;
+	}
+	if (ignored > 0) {
+		std::cerr << "Too many subpaths in " << svgPath << ", " << ignored << " shortest ones are ignored" << std::endl;
+	}
+
+	for (int s = 0; s < m; s++) {
+		int n = polylines[s].size();
+		int share = shares[s];
+		if (share == 0) {
+			continue;
+		}
+		// ڲࣺΪʱߣǿʱ
+		int depth = 0;
+		for (int other = 0; other < m; other++) {
+			if (other != s && polylines[other].size() >= 3 && insidePolyline(polylines[other], polylines[s][0])) {
+				depth++;
+			}
+		}
+		float side = (signedArea(polylines[s]) > 0.0f) == (depth % 2 == 0) ? 1.0f : -1.0f;
+
+		// λãϵĶ±͵һı
+		std::vector<std::pair<int, float>> samples;
+#ifdef RESAMPLE_MODE
+		std::vector<int> sampleIndexes;
+		adaptiveSampleIndexes(polylines[s], BOUNDARY_TOLERANCE, share, sampleIndexes);
+		for (int index : sampleIndexes) {
+			samples.emplace_back(index, 0.0f);
+		}
+#else
+		float segmentLength = lengths[s] / share, walked = 0.0f;
+		int k = 0;
+		for (int i = 0; i < share; i++) {
+			float target = segmentLength * i;
+			float edge = (polylines[s][(k + 1) % n] - polylines[s][k]).norm();
+			while (k + 1 < n && walked + edge <= target) {
+				walked += edge;
+				k++;
+				edge = (polylines[s][(k + 1) % n] - polylines[s][k]).norm();
+			}
+			samples.emplace_back(k, edge > 0.0f ? (target - walked) / edge : 0.0f);
+		}
+#endif // RESAMPLE_MODE
+
+		for (const auto& sample : samples) {
+			// ߵһͬһϣʱߴһε㿪ʼص׸ıһεĩβֵ
+			int next = (sample.first + 1) % n;
+			const SvgVertex& from = vertices[s][sample.first];
+			const SvgVertex& to = vertices[s][next];
+			int segment;
+			float t0, t1;
+			if (next == 0) {
+				segment = from.segment;
+				t0 = from.t;
+				t1 = 1.0f;
+			}
+			else if (to.segment == from.segment) {
+				segment = to.segment;
+				t0 = from.t;
+				t1 = to.t;
+			}
+			else {
+				segment = to.segment;
+				t0 = 0.0f;
+				t1 = to.t;
+			}
+			float t = t0 + (t1 - t0) * sample.second;
+			Eigen::Vector2f point = subpaths[s].segments[segment].point(t);
+			// λߣΪ0Ƶ˵غϣʱΪ0
+			int segmentNum = subpaths[s].segments.size();
+			auto direction = [&](int index, float t) {
+				Eigen::Vector2f derivative = subpaths[s].segments[(index + segmentNum) % segmentNum].derivative(t);
+				return derivative.squaredNorm() > 1e-12f ? Eigen::Vector2f(derivative.normalized()) : Eigen::Vector2f(0.0f, 0.0f);
+			};
+			// εӴʱȡߵƽǴķΪƽ
+			Eigen::Vector2f tangent = direction(segment, t);
+			if (t == 0.0f) {
+				tangent += direction(segment - 1, 1.0f);
+			}
+			else if (t == 1.0f) {
+				tangent += direction(segment + 1, 0.0f);
+			}
+			if (tangent.squaredNorm() < 1e-12f) {
+				tangent = polylines[s][(sample.first + 1) % n] - polylines[s][(sample.first - 1 + n) % n];
+			}
+			Eigen::Vector2f normal = side * Eigen::Vector2f(-tangent.y(), tangent.x()).normalized();
+			boundaryPoints.push_back(point);
+			normalPoints.push_back(point + normal * OFFSET);
+		}
+	}
+
+#ifdef IMAGE_DEBUG
+	showConstraintPoints(cv::Size(cols, rows), boundaryPoints, normalPoints);
+#endif // IMAGE_DEBUG
+	return !boundaryPoints.empty();
+}
+
+#endif
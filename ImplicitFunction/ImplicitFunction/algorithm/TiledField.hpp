@@ -0,0 +1,75 @@
+#ifndef __TILED_FIELD_HPP__
+#define __TILED_FIELD_HPP__
+
+#define TILE_SHIFT 5
+#define TILE_SIZE (1 << TILE_SHIFT)
+#include <vector>
+#include <algorithm>
+
+// ֿ洢ĲֵxNum  yNumTILE_SIZE  TILE_SIZEֿ飬ÿţ4KB
+// ڰxy˳У¼ÿСֵֵ
+// (tx, ty)Ԫi[tx * TILE_SIZE, (tx + 1) * TILE_SIZE)j[ty * TILE_SIZE, (ty + 1) * TILE_SIZE)
+// ֵԪϷһһ㣬ֵܸǿеԪĽǵ
+struct TiledField {
+	int xNum = 0, yNum = 0;
+	int xTiles = 0, yTiles = 0;
+	std::vector<float> data;
+	std::vector<float> minValues, maxValues;
+
+	TiledField() = default;
+
+	// valuesxy˳ţindex = i * yNum + j
+	TiledField(const float* values, int xNum, int yNum) {
+		build(values, xNum, yNum);
+	}
+
+	void build(const float* values, int xNum, int yNum) {
+		this->xNum = xNum;
+		this->yNum = yNum;
+		xTiles = (xNum + TILE_SIZE - 1) >> TILE_SHIFT;
+		yTiles = (yNum + TILE_SIZE - 1) >> TILE_SHIFT;
+		data.assign(static_cast<size_t>(xTiles) * yTiles * TILE_SIZE * TILE_SIZE, 0.0f);
+		minValues.resize(xTiles * yTiles);
+		maxValues.resize(xTiles * yTiles);
+		for (int i = 0; i < xNum; i++) {
+			for (int j = 0; j < yNum; j++) {
+				data[offset(i, j)] = values[i * yNum + j];
+			}
+		}
+		for (int tx = 0; tx < xTiles; tx++) {
+			for (int ty = 0; ty < yTiles; ty++) {
+				int i0, i1, j0, j1;
+				tileCells(tx, ty, i0, i1, j0, j1);
+				float minValue = at(i0, j0), maxValue = minValue;
+				for (int i = i0; i <= i1; i++) {
+					for (int j = j0; j <= j1; j++) {
+						float value = at(i, j);
+						minValue = std::min(minValue, value);
+						maxValue = std::max(maxValue, value);
+					}
+				}
+				minValues[tx * yTiles + ty] = minValue;
+				maxValues[tx * yTiles + ty] = maxValue;
+			}
+		}
+	}
+
+	size_t offset(int i, int j) const {
+		int tile = (i >> TILE_SHIFT) * yTiles + (j >> TILE_SHIFT);
+		return (static_cast<size_t>(tile) << (2 * TILE_SHIFT)) + ((i & (TILE_SIZE - 1)) << TILE_SHIFT) + (j & (TILE_SIZE - 1));
+	}
+
+	float at(int i, int j) const {
+		return data[offset(i, j)];
+	}
+
+	// ڵԪķΧi[i0, i1)j[j0, j1)ӦĽǵ㷶ΧΪi[i0, i1]j[j0, j1]
+	void tileCells(int tx, int ty, int& i0, int& i1, int& j0, int& j1) const {
+		i0 = tx * TILE_SIZE;
+		j0 = ty * TILE_SIZE;
+		i1 = std::min(i0 + TILE_SIZE, xNum - 1);
+		j1 = std::min(j0 + TILE_SIZE, yNum - 1);
+	}
+};
+
+#endif
@@ -0,0 +1,139 @@
+#ifndef __VERTEX_ARENA_HPP__
+#define __VERTEX_ARENA_HPP__
+
+#define ARENA_INITIAL_SIZE 65536
+#define ARENA_BUDGET 268435456
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <memory>
+
+// ڴԤ㣺ڴص֮Ͳlimit¼֮͵ĸˮλ
+class ArenaBudget {
+public:
+	ArenaBudget(size_t limit) : limit(limit) {
+	}
+
+	// bytesֽڵԤ㣬ʱfalse
+	bool acquire(size_t bytes) {
+		size_t current = used.load(std::memory_order_relaxed);
+		do {
+			if (current + bytes > limit) {
+				return false;
+			}
+		} while (!used.compare_exchange_weak(current, current + bytes, std::memory_order_relaxed));
+		size_t high = highWater.load(std::memory_order_relaxed);
+		while (current + bytes > high && !highWater.compare_exchange_weak(high, current + bytes, std::memory_order_relaxed)) {
+		}
+		return true;
+	}
+
+	void release(size_t bytes) {
+		used.fetch_sub(bytes, std::memory_order_relaxed);
+	}
+
+	size_t getUsed() const {
+		return used.load(std::memory_order_relaxed);
+	}
+
+	size_t getHighWater() const {
+		return highWater.load(std::memory_order_relaxed);
+	}
+
+	size_t getLimit() const {
+		return limit;
+	}
+
+private:
+	size_t limit;
+	std::atomic<size_t> used{ 0 };
+	std::atomic<size_t> highWater{ 0 };
+};
+
+// жڴعõԤ
+ArenaBudget& vertexBudget() {
+	static ArenaBudget budget(ARENA_BUDGET);
+	return budget;
+}
+
+// ĶڴأARENA_INITIAL_SIZEʼ2֡ظʹöͷţ֮Ԥ
+// ҲԹⲿڴ棨־ӳOpenGL壩ⲿڴ治Ԥ㣬ŲʱԼڴ
+class VertexArena {
+public:
+	VertexArena(ArenaBudget& budget = vertexBudget()) : budget(&budget) {
+	}
+
+	~VertexArena() {
+		budget->release(ownedCapacity());
+	}
+
+	VertexArena(const VertexArena&) = delete;
+	VertexArena& operator=(const VertexArena&) = delete;
+
+	// ֤bytesֽڣʱԭݣԤʱfalseԭڴ治
+	bool reserve(size_t bytes) {
+		highWater = std::max(highWater, bytes);
+		if (bytes <= capacity) {
+			return true;
+		}
+		size_t owned = ownedCapacity();
+		size_t newCapacity = std::max<size_t>(owned, ARENA_INITIAL_SIZE);
+		while (newCapacity < bytes) {
+			newCapacity *= 2;
+		}
+		// 2ԤʱֻҪĴС
+		if (!budget->acquire(newCapacity - owned)) {
+			newCapacity = bytes;
+			if (!budget->acquire(newCapacity - owned)) {
+				std::cerr << "Vertex memory budget exceeded." << std::endl;
+				return false;
+			}
+		}
+		storage.reset(new float[(newCapacity + sizeof(float) - 1) / sizeof(float)]);
+		external = nullptr;
+		capacity = newCapacity;
+		return true;
+	}
+
+	// ⲿbytesֽڴ棬ͷԼڴ棬ԭݲ
+	void attach(float* memory, size_t bytes) {
+		if (external == memory && capacity == bytes) {
+			return;
+		}
+		budget->release(ownedCapacity());
+		storage.reset();
+		external = memory;
+		capacity = bytes;
+	}
+
+	float* data() {
+		return external ? external : storage.get();
+	}
+
+	const float* data() const {
+		return external ? external : storage.get();
+	}
+
+	size_t getCapacity() const {
+		return capacity;
+	}
+
+	// ֽ
+	size_t getHighWater() const {
+		return highWater;
+	}
+
+private:
+	ArenaBudget* budget;
+	std::unique_ptr<float[]> storage;
+	float* external = nullptr;
+	size_t capacity = 0;
+	size_t highWater = 0;
+
+	// Ԥ
+	size_t ownedCapacity() const {
+		return external ? 0 : capacity;
+	}
+};
+
+#endif
@@ -2,15 +2,54 @@
 #define EDGE_MODEx
 #define DATA_DEBUGx
 #define IMAGE_DEBUGx
+#define EIGEN_SOLVERx
+#define ADAPTIVE_MODEx
+#define LU_BENCHMARKx
+#define CONTOUR_MODEx
+#define COEFFICIENT_MODEx
+#define GPU_MODEx
+#define ALLOC_DEBUGx
+#define TRACE_MODEx
+#define RESAMPLE_MODEx
+#define PYRAMID_MODEx
+#define VIDEO_MODEx
+#define SDF_MODEx
+#define SDF_COMPAREx
 #define DIMENSION 3
 #define MAX_MATRIX_DIMENSION 200
-#define MAX_ALLOC_SIZE 10485760
 #define OPENGL_SCALE 100.0f
+#define COEFFICIENT_RESOLUTION 256
+#define GPU_MAX_FIELDS 16
+#define SDF_COMPARE_BUCKET 8
+
+// 每个点（实例）和边的端点的浮点数：点边模式下坐标之后是该边作为凹包边界时α的区间
+#ifdef EDGE_MODE
+#define VERTEX_FLOATS (DIMENSION + 2)
+#else
+#define VERTEX_FLOATS DIMENSION
+#endif
+
+#if defined(GPU_MODE) && defined(COEFFICIENT_MODE)
+#error GPU_MODE blends the sampled fields, COEFFICIENT_MODE must be disabled
+#endif
+#if defined(SDF_MODE) && defined(COEFFICIENT_MODE)
+#error SDF_MODE writes no model files, COEFFICIENT_MODE must be disabled
+#endif
 
 #include "algorithm/ImplicitFunction.hpp"
 #include "algorithm/PointProcess.hpp"
 #include "algorithm/ImageProcess.hpp"
+#include "algorithm/SvgProcess.hpp"
+#include "algorithm/ModelCache.hpp"
+#include "algorithm/AdaptiveSampling.hpp"
+#include "algorithm/TiledField.hpp"
+#include "algorithm/VertexArena.hpp"
+#include "algorithm/InterpolationWorker.hpp"
+#include "algorithm/FrameCache.hpp"
+#include "algorithm/FrameSequence.hpp"
+#include "algorithm/DistanceField.hpp"
 #include "settings/Shader.h"
+#include "settings/VertexStream.h"
 #include "settings/Camera.h"
 #include "settings/Setting.hpp"
 #include "imgui.h"
@@ -32,7 +71,59 @@
 #include <vector>
 #include <iostream>
 #include <fstream>
+#include <filesystem>
+#include <iomanip>
 #include <string>
+#include <chrono>
+#include <random>
+#include <mutex>
+#include <cfloat>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#ifdef ALLOC_DEBUG
+// 分配计数：替换全局的operator new，统计计算每一帧时的堆分配次数，稳态交互时应为0
+// 计数是进程范围的，OpenMP工作线程在并行区域中的分配也会算进来；只在有AllocationScope存在时计数，
+// 计算一帧的同时渲染线程（ImGui、上传顶点）和预计算线程的分配也会计入，因此窗口中的数字只作参考，
+// 启动时的稳态检查在后台线程创建之前进行，此时没有其它线程分配内存
+std::atomic<int> allocationTracking{ 0 };
+std::atomic<long long> allocationCount{ 0 };
+
+void* operator new(size_t size) {
+    if (allocationTracking.load(std::memory_order_relaxed) > 0) {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (void* pointer = malloc(size ? size : 1)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+    free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    free(pointer);
+}
+
+// 作用域内所有线程的堆分配次数，析构时写入result
+struct AllocationScope {
+    std::atomic<long long>& result;
+    long long start;
+
+    AllocationScope(std::atomic<long long>& result) : result(result) {
+        allocationTracking++;
+        start = allocationCount.load();
+    }
+
+    ~AllocationScope() {
+        result = allocationCount.load() - start;
+        allocationTracking--;
+    }
+};
+#endif // ALLOC_DEBUG
 
 typedef struct Color {
     int b;
@@ -40,183 +131,634 @@ typedef struct Color {
     int r;
 } Color;
 
-// 根据图片得到约束条件
-void generateContraints(
+// 根据图片得到约束条件，图片无法读取或没有得到约束点时返回false
+bool generateContraints(
     const char* imagePath,
     std::vector<pair<Eigen::Vector3f, float>>& constraints,
     int& rows, int& cols)
 {
     std::vector<Eigen::Vector2f> boundaryPoints, normalPoints;
-    processImage3(imagePath, rows, cols, boundaryPoints, normalPoints);
+    // SVG路径直接在曲线上取约束点，不经过图像处理
+    if (isSvgPath(imagePath)) {
+        if (!processSvg(imagePath, rows, cols, boundaryPoints, normalPoints)) {
+            return false;
+        }
+    }
+    else {
+#if defined(PYRAMID_MODE)
+        if (!processImage5(imagePath, rows, cols, boundaryPoints, normalPoints)) {
+            return false;
+        }
+#elif defined(TRACE_MODE)
+        if (!processImage4(imagePath, rows, cols, boundaryPoints, normalPoints)) {
+            return false;
+        }
+#else
+        processImage3(imagePath, rows, cols, boundaryPoints, normalPoints);
+#endif
+    }
+    if (boundaryPoints.empty()) {
+        std::cerr << "No constraint found in " << imagePath << std::endl;
+        return false;
+    }
     for (const auto& point : boundaryPoints) {
         constraints.emplace_back(Eigen::Vector3f(point.x(), point.y(), 0.0f), 0.0f);
     }
     for (const auto& point : normalPoints) {
         constraints.emplace_back(Eigen::Vector3f(point.x(), point.y(), 0.0f), 1.0f);
     }
+    return true;
 }
 
-// 将两张图片像素点的隐函数值写入文件
-bool writeImageValue(
-    int& rows,
-    int& cols,
-    const char* imagePath_1,
-    const char* imagePath_2)
+// 根据图片得到隐函数及其采样值，优先从缓存中读取
+bool loadImplicitFunction(
+    const char* imagePath,
+    ModelCache& cache,
+    ImplicitFunctionModel& model,
+    std::vector<float>& field)
 {
-    std::vector<std::pair<Eigen::Vector3f, float>> constraints_1, constraints_2;
-    int rows_1, cols_1;
-    int rows_2, cols_2;
-    // 根据输入图片得到边界约束和法向约束
-    generateContraints(imagePath_1, constraints_1, rows_1, cols_1);
-    generateContraints(imagePath_2, constraints_2, rows_2, cols_2);
-    // 假设两张图片的大小是一样的
-    rows = rows_1;
-    cols = cols_1;
-
-    Eigen::VectorXf weights_1, weights_2;
-    float P0_1, P0_2;
-    Eigen::Vector3f P_1, P_2;
+    uint64_t key;
+    if (!cache.key(imagePath, key)) {
+        std::cerr << "Failed to read " << imagePath << std::endl;
+        return false;
+    }
+    if (cache.load(key, model, &field)) {
+        return true;
+    }
+#ifdef SDF_MODE
+    // 符号距离场模式：直接由边界得到采样值，不求解线性方程组，model中只有图片大小；SVG仍然求解径向基函数
+    if (!isSvgPath(imagePath)) {
+        if (!distanceFieldImage(imagePath, model.rows, model.cols, field)) {
+            return false;
+        }
+        cache.store(key, model, &field);
+        return true;
+    }
+#endif // SDF_MODE
+    // 根据输入图片得到边界约束和法向约束，失败时不写入缓存
+    if (!generateContraints(imagePath, model.constraints, model.rows, model.cols)) {
+        return false;
+    }
     // 解线性方程组得到隐函数参数
-    if (!solveImplicitEquation(constraints_1, weights_1, P0_1, P_1)) {
+    if (!solveImplicitEquation(model.constraints, model.weights, model.P0, model.P)) {
         return false;
     }
-    if (!solveImplicitEquation(constraints_2, weights_2, P0_2, P_2)) {
+    // 两个隐函数混合时需要远离各自零值线处的准确值，写入和缓存的采样值始终逐点计算
+    sampleImplicitFunction(model, field);
+#ifdef ADAPTIVE_MODE
+    std::vector<Polyline> polylines;
+    AdaptiveStatistics statistics;
+    adaptiveSampleImplicitFunction(model, polylines, &statistics);
+    size_t points = 0;
+    for (const auto& polyline : polylines) {
+        points += polyline.points.size();
+    }
+    std::cout << "Adaptive sampling: " << statistics.evaluations << " of " << field.size() << " samples evaluated, "
+        << polylines.size() << " polylines, " << points << " zero points" << std::endl;
+#endif // ADAPTIVE_MODE
+    cache.store(key, model, &field);
+    return true;
+}
+
+// 将隐函数采样值写入文件
+bool writeFieldFile(const char* filePath, int rows, int cols, const std::vector<float>& field)
+{
+    ofstream file(filePath);
+    if (!file) {
         return false;
     }
+    file << rows << std::endl << cols << std::endl << STEP << std::endl;
+    file << std::setprecision(std::numeric_limits<float>::max_digits10);
+    for (float value : field) {
+        file << value << '\n';
+    }
+    return static_cast<bool>(file);
+}
 
-    ofstream file1("../../../../ImplicitFunction/resources/image1_value.txt");
-    ofstream file2("../../../../ImplicitFunction/resources/image2_value.txt");
-    if (!file1 || !file2) {
+// 读取隐函数采样值文件，并按块重新组织采样值
+bool readFieldFile(const char* filePath, int& rows, int& cols, TiledField& field)
+{
+    ifstream file(filePath);
+    if (!file) {
         return false;
     }
-    file1 << rows_1 << std::endl << cols_1 << std::endl << STEP << std::endl;
-    file2 << rows_2 << std::endl << cols_2 << std::endl << STEP << std::endl;
-    float value;
-    for (int x = 0; x < cols; x += STEP) {
-        for (int y = 0; y < rows; y += STEP) {
-            for (int z = 0; z <= 0; z += STEP) {
-                value = implicitFunctionValue(Eigen::Vector3f(x, y, z), constraints_1, weights_1, P0_1, P_1);
-                file1 << std::setprecision(std::numeric_limits<float>::max_digits10) << value << std::endl;
-                value = implicitFunctionValue(Eigen::Vector3f(x, y, z), constraints_2, weights_2, P0_2, P_2);
-                file2 << std::setprecision(std::numeric_limits<float>::max_digits10) << value << std::endl;
+    std::string line;
+    int step = 0;
+    for (int i = 0; i < 3; i++) {
+        if (!std::getline(file, line)) {
+            return false;
+        }
+        if (i == 0) {
+            rows = std::stoi(line);
+        }
+        else if (i == 1) {
+            cols = std::stoi(line);
+        }
+        else {
+            step = std::stoi(line);
+        }
+    }
+    if (step != STEP) {
+        std::cerr << filePath << " was sampled with STEP = " << step << ", expected " << STEP << std::endl;
+        return false;
+    }
+    int xNum = (cols + STEP - 1) / STEP;
+    int yNum = (rows + STEP - 1) / STEP;
+    std::vector<float> values(xNum * yNum);
+    for (auto& value : values) {
+        if (!std::getline(file, line)) {
+            return false;
+        }
+        value = std::stof(line);
+    }
+    field.build(values.data(), xNum, yNum);
+    return true;
+}
+
+// 将多张图片像素点的隐函数值依次写入image1_value.txt, image2_value.txt, ...
+bool writeImageValue(
+    int& rows,
+    int& cols,
+    const std::vector<const char*>& imagePaths)
+{
+    ModelCache cache("../../../../ImplicitFunction/resources/cache/");
+    for (size_t k = 0; k < imagePaths.size(); k++) {
+        ImplicitFunctionModel model;
+        std::vector<float> field;
+        if (!loadImplicitFunction(imagePaths[k], cache, model, field)) {
+            return false;
+        }
+        // 所有图片的大小需要一致
+        if (k == 0) {
+            rows = model.rows;
+            cols = model.cols;
+        }
+        else if (model.rows != rows || model.cols != cols) {
+            std::cerr << imagePaths[k] << " has a different size from " << imagePaths[0] << std::endl;
+            return false;
+        }
+        std::string filePath = "../../../../ImplicitFunction/resources/image" + std::to_string(k + 1);
+        if (!writeFieldFile((filePath + "_value.txt").c_str(), model.rows, model.cols, field)) {
+            return false;
+        }
+        // 符号距离场没有径向基函数的系数，不写系数文件，并删除之前写入的系数文件，避免与新的采样值不一致
+        if (model.constraints.empty()) {
+            std::error_code error;
+            std::filesystem::remove(filePath + "_model.txt", error);
+            std::filesystem::remove(filePath + "_contour.txt", error);
+        }
+        else if (!writeModelFile((filePath + "_model.txt").c_str(), model)) {
+            return false;
+        }
+#ifdef CONTOUR_MODE
+        // 在CONTOUR_STEP的粗网格上找零值点并用牛顿法投影到零值集合上，写出亚像素的边界和法向；符号距离场没有系数，不能求值，跳过
+        if (!model.constraints.empty()) {
+            std::vector<Polyline> polylines;
+            std::vector<std::vector<Eigen::Vector3f>> normals;
+            getRefinedZeroValuePoints(model, CONTOUR_STEP, polylines, &normals);
+            if (!writeContourFile((filePath + "_contour.txt").c_str(), polylines, normals)) {
+                return false;
             }
         }
-        if (x % 10 == 0) {
-            std::cout << "Finish writing cols[" << x << "]" << std::endl;
+#endif // CONTOUR_MODE
+    }
+    const CacheStatistics& statistics = cache.getStatistics();
+    std::cout << "Cache hits: " << statistics.hits << ", misses: " << statistics.misses
+        << ", evictions: " << statistics.evictions << std::endl;
+    std::cout << "Suceessfully write image1_value.txt to image" << imagePaths.size() << "_value.txt and the model files" << std::endl;
+    return true;
+}
+
+// 读取视频或图片序列（如frame_%04d.png），逐帧跟踪边界并求解隐函数，每SEQUENCE_STRIDE帧依次写入image1_value.txt, image2_value.txt, ...
+// 与writeImageValue()写入的文件相同，插值时相邻两帧的形状即为相邻的关键帧
+bool writeSequenceValue(
+    int& rows,
+    int& cols,
+    const char* sequencePath)
+{
+    cv::VideoCapture capture(sequencePath);
+    if (!capture.isOpened()) {
+        std::cerr << "Failed to open " << sequencePath << std::endl;
+        return false;
+    }
+    FrameSequence sequence;
+    cv::Mat frame;
+    int frameIndex = 0, fieldNum = 0;
+    auto start = std::chrono::steady_clock::now();
+    while (capture.read(frame)) {
+        ImplicitFunctionModel model;
+        if (!sequence.next(frame, model)) {
+            return false;
+        }
+        if (frameIndex++ % SEQUENCE_STRIDE != 0) {
+            continue;
+        }
+        if (fieldNum == 0) {
+            rows = model.rows;
+            cols = model.cols;
         }
+        std::vector<float> field;
+        sampleImplicitFunction(model, field);
+        std::string filePath = "../../../../ImplicitFunction/resources/image" + std::to_string(++fieldNum);
+        if (!writeFieldFile((filePath + "_value.txt").c_str(), model.rows, model.cols, field) ||
+            !writeModelFile((filePath + "_model.txt").c_str(), model)) {
+            return false;
+        }
+    }
+    if (fieldNum == 0) {
+        std::cerr << "No frame read from " << sequencePath << std::endl;
+        return false;
     }
-    file1.close();
-    file2.close();
-    std::cout << "Suceessfully write image1_value.txt and image2_value.txt" << std::endl;
+    const SequenceStatistics& statistics = sequence.getStatistics();
+    std::cout << "Frames: " << statistics.frames << ", reused: " << statistics.reused
+        << ", warm starts: " << statistics.warmStarts << " (" << statistics.iterations << " iterations, "
+        << (statistics.warmStarts > 0 ? statistics.warmMilliseconds / statistics.warmStarts : 0.0) << "ms each)"
+        << ", cold solves: " << statistics.coldSolves << " ("
+        << (statistics.coldSolves > 0 ? statistics.coldMilliseconds / statistics.coldSolves : 0.0) << "ms each), total "
+        << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() << "ms" << std::endl;
+    std::cout << "Suceessfully write image1_value.txt to image" << fieldNum << "_value.txt and the model files" << std::endl;
     return true;
 }
 
-// 根据文件读取图片的隐函数值，并插值得到新的边界点
-void implicitFunctionInterpolation(
-    float weight,
-    int rows,
-    int cols,
-    float* fileData_1,
-    float* fileData_2,
-    std::vector<Eigen::Vector3f>& points)
+// 关键帧权重：weight为1时为第一个形状，为0时为最后一个形状，两个形状时与原来image1的权重含义一致
+// 线性模式只在相邻的两个形状之间插值；样条模式用均匀Catmull-Rom样条，权重之和为1，但可能为负
+void keyframeWeights(float weight, int fieldNum, bool spline, std::vector<float>& weights)
 {
-    float weight_1 = weight;
-    float weight_2 = 1.0f - weight;
+    weights.assign(fieldNum, 0.0f);
+    float position = (1.0f - weight) * (fieldNum - 1);
+    int k = std::max(0, std::min(static_cast<int>(position), fieldNum - 2));
+    float t = position - k;
+    if (!spline) {
+        weights[k] = 1.0f - t;
+        weights[k + 1] = t;
+        return;
+    }
+    float t2 = t * t, t3 = t2 * t;
+    float basis[4] = {
+        (-t3 + 2.0f * t2 - t) * 0.5f,
+        (3.0f * t3 - 5.0f * t2 + 2.0f) * 0.5f,
+        (-3.0f * t3 + 4.0f * t2 + t) * 0.5f,
+        (t3 - t2) * 0.5f
+    };
+    // 两端之外的控制点取端点
+    for (int c = 0; c < 4; c++) {
+        weights[std::max(0, std::min(k - 1 + c, fieldNum - 1))] += basis[c];
+    }
+}
 
-    // 读取图片的隐函数值
-    int index = 0;
+// 插值时使用的缓冲，跨帧重复使用时稳态下不再分配内存
+struct InterpolationScratch {
+    std::vector<int> active;
+    std::vector<std::vector<MarchingSegment>> tileSegments;
+    std::vector<MarchingSegment> segments;
+    ChainScratch chain;
+};
+
+// 根据文件读取图片的隐函数值，并插值得到新的边界：在插值结果Σ wᵢ·fᵢ上做marching squares，得到有序的亚像素折线上的点
+// 插值结果在一个块内的取值范围为Σ wᵢ·[minᵢ, maxᵢ]（wᵢ为负时上下界互换），不跨过0的块直接跳过
+// 需要计算的块把各个场连续存放的块数据依次向量化累加到块缓冲中，每个场每帧只读一遍；块右上方多出的一行一列逐点计算
+// 计算被取消时返回false
+bool implicitFunctionInterpolation(
+    const std::vector<float>& weights,
+    const std::vector<TiledField>& fields,
+    std::vector<Eigen::Vector3f>& points,
+    InterpolationScratch& scratch,
+    const CancelToken& cancel = CancelToken())
+{
+    const TiledField& grid = fields[0];
+    // 权重为0的场不参与计算
+    std::vector<int>& active = scratch.active;
+    active.clear();
+    for (int k = 0; k < static_cast<int>(fields.size()); k++) {
+        if (weights[k] != 0.0f) {
+            active.push_back(k);
+        }
+    }
+    if (active.empty()) {
+        return true;
+    }
+    int tileNum = grid.xTiles * grid.yTiles;
+    // 每块的线段列表清空时保留容量
+    auto& tileSegments = scratch.tileSegments;
+    if (static_cast<int>(tileSegments.size()) < tileNum) {
+        tileSegments.resize(tileNum);
+    }
 #pragma omp parallel
-    for (int x = 0; x < cols; x += STEP) {
-        for (int y = 0; y < rows; y += STEP) {
-            for (int z = 0; z <= 0; z += STEP) {
-                float value1 = fileData_1[index];
-                float value2 = fileData_2[index];
-                if (isZero(weight_1 * value1 + weight_2 * value2)) {
-                    points.push_back(Eigen::Vector3f(x, y, z));
+    {
+        alignas(64) float blended[TILE_SIZE * TILE_SIZE];
+#pragma omp for schedule(dynamic)
+        for (int tile = 0; tile < tileNum; tile++) {
+            tileSegments[tile].clear();
+            float minValue = 0.0f, maxValue = 0.0f;
+            for (int k : active) {
+                float w = weights[k];
+                minValue += w * (w > 0.0f ? fields[k].minValues[tile] : fields[k].maxValues[tile]);
+                maxValue += w * (w > 0.0f ? fields[k].maxValues[tile] : fields[k].minValues[tile]);
+            }
+            if (minValue > 0.0f || maxValue <= 0.0f || cancel.cancelled()) {
+                continue;
+            }
+            size_t base = static_cast<size_t>(tile) << (2 * TILE_SHIFT);
+            float* out = blended;
+            const float* in = fields[active[0]].data.data() + base;
+            float w = weights[active[0]];
+#pragma omp simd
+            for (int s = 0; s < TILE_SIZE * TILE_SIZE; s++) {
+                out[s] = w * in[s];
+            }
+            for (size_t a = 1; a < active.size(); a++) {
+                in = fields[active[a]].data.data() + base;
+                w = weights[active[a]];
+#pragma omp simd
+                for (int s = 0; s < TILE_SIZE * TILE_SIZE; s++) {
+                    out[s] += w * in[s];
+                }
+            }
+            int i0, i1, j0, j1;
+            grid.tileCells(tile / grid.yTiles, tile % grid.yTiles, i0, i1, j0, j1);
+            auto value = [&](int i, int j) {
+                int di = i - i0, dj = j - j0;
+                if (di < TILE_SIZE && dj < TILE_SIZE) {
+                    return out[(di << TILE_SHIFT) + dj];
+                }
+                float sum = 0.0f;
+                for (int k : active) {
+                    sum += weights[k] * fields[k].at(i, j);
+                }
+                return sum;
+            };
+            marchingSquaresCells(value, grid.yNum, STEP, i0, i1, j0, j1, tileSegments[tile]);
+        }
+    }
+    if (cancel.cancelled()) {
+        return false;
+    }
+    std::vector<MarchingSegment>& segments = scratch.segments;
+    segments.clear();
+    for (int tile = 0; tile < tileNum; tile++) {
+        segments.insert(segments.end(), tileSegments[tile].begin(), tileSegments[tile].end());
+    }
+    chainSegmentPoints(segments, points, scratch.chain);
+    return true;
+}
+
+// 把所有形状的采样值上传为R32F二维纹理数组：第k层为第k个形状，宽为yNum，高为xNum，网格点(i, j)位于第i行第j列
+void uploadFieldTexture(const std::vector<TiledField>& fields, unsigned int& texture)
+{
+    int xNum = fields[0].xNum, yNum = fields[0].yNum;
+    std::vector<float> values(static_cast<size_t>(xNum) * yNum * fields.size());
+    size_t index = 0;
+    for (const auto& field : fields) {
+        for (int i = 0; i < xNum; i++) {
+            for (int j = 0; j < yNum; j++) {
+                values[index++] = field.at(i, j);
+            }
+        }
+    }
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_R32F, yNum, xNum, fields.size(), 0, GL_RED, GL_FLOAT, values.data());
+    // 着色器用texelFetch自己做双线性插值，这里只需要保证纹理完整（没有多级渐远纹理）
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+}
+
+// 视口在图片坐标系中的范围(x0, y0, x1, y1)：把视锥的四条棱与z = 0平面求交，再与图片范围取交集
+// 有棱与平面不相交时（相机倾斜过大）返回整张图片
+Eigen::Vector4f viewportRegion(const glm::mat4& projection, const glm::mat4& view, int rows, int cols, const float* offset)
+{
+    Eigen::Vector4f image(0.0f, 0.0f, static_cast<float>(cols), static_cast<float>(rows));
+    glm::mat4 inverse = glm::inverse(projection * view);
+    float x0 = FLT_MAX, y0 = FLT_MAX, x1 = -FLT_MAX, y1 = -FLT_MAX;
+    for (float ndcX : { -1.0f, 1.0f }) {
+        for (float ndcY : { -1.0f, 1.0f }) {
+            glm::vec4 nearPoint = inverse * glm::vec4(ndcX, ndcY, -1.0f, 1.0f);
+            glm::vec4 farPoint = inverse * glm::vec4(ndcX, ndcY, 1.0f, 1.0f);
+            nearPoint /= nearPoint.w;
+            farPoint /= farPoint.w;
+            float dz = farPoint.z - nearPoint.z;
+            float t = fabs(dz) > 1e-6f ? -nearPoint.z / dz : -1.0f;
+            if (t < 0.0f || t > 1.0f) {
+                return image;
+            }
+            glm::vec4 point = nearPoint + t * (farPoint - nearPoint);
+            // OpenGL坐标转换为图片坐标，Y轴翻转
+            float x = point.x * OPENGL_SCALE - offset[0];
+            float y = -point.y * OPENGL_SCALE - offset[1];
+            x0 = std::min(x0, x);
+            y0 = std::min(y0, y);
+            x1 = std::max(x1, x);
+            y1 = std::max(y1, y);
+        }
+    }
+    return Eigen::Vector4f(std::max(x0, image[0]), std::max(y0, image[1]), std::min(x1, image[2]), std::min(y1, image[3]));
+}
+
+#ifdef LU_BENCHMARK
+// 对比自己的LU分解和Eigen::PartialPivLU的耗时与残差
+void benchmarkLinearSystem(int n)
+{
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+    Eigen::MatrixXd A(n, n);
+    Eigen::VectorXd B(n);
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            A(i, j) = distribution(generator);
+        }
+        B(i) = distribution(generator);
+    }
+    std::vector<double> rowMajorA(n * n), vectorB(B.data(), B.data() + n), vectorX;
+    Eigen::Map<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>(rowMajorA.data(), n, n) = A;
+
+    auto start = std::chrono::steady_clock::now();
+    solve(rowMajorA, vectorB, vectorX, n);
+    auto middle = std::chrono::steady_clock::now();
+    Eigen::VectorXd X = Eigen::PartialPivLU<Eigen::MatrixXd>(A).solve(B);
+    auto end = std::chrono::steady_clock::now();
+
+    double residual = (A * Eigen::Map<Eigen::VectorXd>(vectorX.data(), n) - B).norm() / B.norm();
+    double eigenResidual = (A * X - B).norm() / B.norm();
+    std::cout << "n = " << n
+        << "\tLinearSystem: " << std::chrono::duration<double, std::milli>(middle - start).count() << "ms, residual " << residual
+        << "\tEigen::PartialPivLU: " << std::chrono::duration<double, std::milli>(end - middle).count() << "ms, residual " << eigenResidual
+        << std::endl;
+}
+#endif // LU_BENCHMARK
+
+#ifdef SDF_COMPARE
+// 采样值的零值线（marching squares）到参考边界的距离：对参考边界上的每个点求到零值线的最近距离，得到平均值和最大值
+// 零值线的线段按包围盒放入边长为SDF_COMPARE_BUCKET像素的网格，每个点由近到远逐圈查找，
+// 查完第r圈后，没查过的线段到该点的距离都不小于r个格子，已找到的距离不超过它时停止
+void zeroSetDeviation(
+    const std::vector<float>& field, int rows, int cols,
+    const std::vector<Eigen::Vector2f>& contour,
+    double& meanDistance, double& maxDistance)
+{
+    int xNum = (cols + STEP - 1) / STEP;
+    int yNum = (rows + STEP - 1) / STEP;
+    std::vector<Polyline> polylines;
+    marchingSquares([&](int i, int j) { return field[i * yNum + j]; }, xNum, yNum, STEP, polylines);
+    std::vector<std::pair<Eigen::Vector2f, Eigen::Vector2f>> segments;
+    for (const auto& polyline : polylines) {
+        int n = polyline.points.size();
+        for (int k = 0; k + (polyline.closed ? 0 : 1) < n; k++) {
+            segments.emplace_back(polyline.points[k].head<2>(), polyline.points[(k + 1) % n].head<2>());
+        }
+    }
+    meanDistance = 0.0;
+    maxDistance = 0.0;
+    if (segments.empty() || contour.empty()) {
+        return;
+    }
+    int bx = cols / SDF_COMPARE_BUCKET + 1, by = rows / SDF_COMPARE_BUCKET + 1;
+    auto bucketOf = [](float value, int num) {
+        return std::max(0, std::min(num - 1, static_cast<int>(std::floor(value / SDF_COMPARE_BUCKET))));
+    };
+    std::vector<std::vector<int>> buckets(bx * by);
+    for (int s = 0; s < segments.size(); s++) {
+        const auto& [a, b] = segments[s];
+        int x0 = bucketOf(std::min(a.x(), b.x()), bx), x1 = bucketOf(std::max(a.x(), b.x()), bx);
+        int y0 = bucketOf(std::min(a.y(), b.y()), by), y1 = bucketOf(std::max(a.y(), b.y()), by);
+        for (int x = x0; x <= x1; x++) {
+            for (int y = y0; y <= y1; y++) {
+                buckets[x * by + y].push_back(s);
+            }
+        }
+    }
+    double sum = 0.0, maximum = 0.0;
+#pragma omp parallel for reduction(+:sum) reduction(max:maximum)
+    for (int p = 0; p < static_cast<int>(contour.size()); p++) {
+        const Eigen::Vector2f& point = contour[p];
+        int cx = bucketOf(point.x(), bx), cy = bucketOf(point.y(), by);
+        float distance = FLT_MAX;
+        for (int r = 0; r < std::max(bx, by); r++) {
+            for (int x = std::max(0, cx - r); x <= std::min(bx - 1, cx + r); x++) {
+                for (int y = std::max(0, cy - r); y <= std::min(by - 1, cy + r); y++) {
+                    // 只查第r圈上的格子
+                    if (std::abs(x - cx) != r && std::abs(y - cy) != r) {
+                        continue;
+                    }
+                    for (int s : buckets[x * by + y]) {
+                        distance = std::min(distance, segmentDistance(point, segments[s].first, segments[s].second));
+                    }
                 }
-                index++;
+            }
+            if (distance <= static_cast<float>(r * SDF_COMPARE_BUCKET)) {
+                break;
             }
         }
+        sum += distance;
+        maximum = std::max<double>(maximum, distance);
     }
+    meanDistance = sum / contour.size();
+    maxDistance = maximum;
 }
 
-// 点模式：OpenGL仅显示点
+// 对比径向基函数和符号距离场的耗时，以及两者的零值线与processImage4()得到的亚像素边界的偏差
+void compareDistanceField(const char* imagePath)
+{
+    cv::Mat grayImage;
+    float sign;
+    if (!readTraceImage(imagePath, grayImage, sign)) {
+        return;
+    }
+    std::vector<Eigen::Vector2f> contour;
+    traceBoundary([&](int y, int x) {
+        return sign * (grayImage.at<uchar>(y, x) - TRACE_THRESHOLD);
+    }, grayImage.rows, grayImage.cols, sign > 0.0f ? -TRACE_THRESHOLD : TRACE_THRESHOLD - 255.0f, contour);
+
+    auto start = std::chrono::steady_clock::now();
+    ImplicitFunctionModel model;
+    std::vector<float> rbfField;
+    if (!generateContraints(imagePath, model.constraints, model.rows, model.cols) ||
+        !solveImplicitEquation(model.constraints, model.weights, model.P0, model.P)) {
+        return;
+    }
+    sampleImplicitFunction(model, rbfField);
+    auto middle = std::chrono::steady_clock::now();
+    int rows, cols;
+    std::vector<float> sdfField;
+    if (!distanceFieldImage(imagePath, rows, cols, sdfField)) {
+        return;
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double rbfMean, rbfMax, sdfMean, sdfMax;
+    zeroSetDeviation(rbfField, model.rows, model.cols, contour, rbfMean, rbfMax);
+    zeroSetDeviation(sdfField, rows, cols, contour, sdfMean, sdfMax);
+    std::cout << imagePath
+        << "\tRBF: " << std::chrono::duration<double, std::milli>(middle - start).count() << "ms, boundary deviation mean " << rbfMean << "px, max " << rbfMax << "px"
+        << "\tSDF: " << std::chrono::duration<double, std::milli>(end - middle).count() << "ms, boundary deviation mean " << sdfMean << "px, max " << sdfMax << "px"
+        << std::endl;
+}
+#endif // SDF_COMPARE
+
+// 计算一帧时使用的缓冲，每个计算帧的线程各有一份，跨帧重复使用
+struct FrameScratch {
+    std::vector<float> weights;
+    std::vector<Eigen::Vector3f> points;
+    InterpolationScratch interpolation;
+    AlphaShape alphaShape;
+    std::vector<size_t> hullSizes;
+};
+
+// 点模式：OpenGL仅显示点，每个点是立方体网格的一个实例，这里只需要写入点的中心（图片坐标）
 bool presentPoint(
-    std::vector<Eigen::Vector3f> points,
-    int& actualPointSize,
-    float* actualPointVertices,
-    float* offset)
+    const std::vector<Eigen::Vector3f>& points,
+    int& pointCenterSize,
+    VertexArena& pointCenters)
 {
-    vector<Eigen::Vector3f> actualPoints;
-    pointConvertTriangle(points, actualPoints);
-    actualPointSize = actualPoints.size() * DIMENSION * sizeof(float);
-    if (actualPointSize > MAX_ALLOC_SIZE) {
-        std::cerr << "OpenGL data size is too large." << std::endl;
+    pointCenterSize = points.size() * DIMENSION * sizeof(float);
+    if (!pointCenters.reserve(pointCenterSize)) {
         return false;
     }
     int index = 0;
-    for (int i = 0; i < actualPoints.size(); i++) {
+    for (const auto& point : points) {
         for (int j = 0; j < DIMENSION; j++) {
-            actualPointVertices[index] = (actualPoints[i][j] + offset[j]) / OPENGL_SCALE;
-            // 因为OPENGL坐标系和图片坐标系的Y轴方向相反，所以需要翻转Y轴
-            if (j == 1) {
-                actualPointVertices[index] = -actualPointVertices[index];
-            }
-            index++;
+            pointCenters.data()[index++] = point[j];
         }
     }
     return true;
 }
 
-// 点边模式：OpenGL显示α-shape算法处理后的点和边
+// 点边模式：OpenGL显示α-shape的点和边，点的中心和边的端点均为图片坐标
+// 每条Delaunay边写入一个点（第一个端点）和两个端点，坐标之后是该边作为凹包边界时α的区间，
+// 着色器按当前的α筛选，改变α时不需要重新计算
 bool presentPointAndEdge(
-    std::vector<Eigen::Vector3f> points,
-    int& actualPointSize,
+    const std::vector<Eigen::Vector3f>& points,
+    int& pointCenterSize,
     int& edgePointSize,
-    float* actualPointVertices,
-    float* edgePointVertices,
-    float* offset)
+    VertexArena& pointCenters,
+    VertexArena& edgePointVertices,
+    FrameScratch& scratch)
 {
-    std::vector<int> pointIndexes;
-    std::vector<std::pair<int, int>> edgeIndexes;
-    ConcaveHull(points, pointIndexes, edgeIndexes);
-    vector<Eigen::Vector3f> actualPoints;
-    pointIndexConvertTriangle(points, pointIndexes, actualPoints);
-
-    actualPointSize = actualPoints.size() * DIMENSION * sizeof(float);
-    edgePointSize = edgeIndexes.size() * 2 * DIMENSION * sizeof(float);
-    if (actualPointSize > MAX_ALLOC_SIZE || edgePointSize > MAX_ALLOC_SIZE) {
-        std::cerr << "OpenGL data size is too large." << std::endl;
+    scratch.alphaShape.build(points);
+    const std::vector<AlphaEdge>& edges = scratch.alphaShape.getEdges();
+
+    pointCenterSize = edges.size() * VERTEX_FLOATS * sizeof(float);
+    edgePointSize = edges.size() * 2 * VERTEX_FLOATS * sizeof(float);
+    if (!pointCenters.reserve(pointCenterSize) || !edgePointVertices.reserve(edgePointSize)) {
         return false;
     }
-    int index = 0;
-    for (int i = 0; i < actualPoints.size(); i++) {
-        for (int j = 0; j < DIMENSION; j++) {
-            actualPointVertices[index] = (actualPoints[i][j] + offset[j]) / OPENGL_SCALE;
-            // 因为OPENGL坐标系和图片坐标系的Y轴方向相反，所以需要翻转Y轴
-            if (j == 1) {
-                actualPointVertices[index] = -actualPointVertices[index];
-            }
-            index++;
-        }
-    }
-    index = 0;
-    for (int i = 0; i < edgeIndexes.size(); i++) {
-        Eigen::Vector3f startPoint = points[edgeIndexes[i].first];
-        Eigen::Vector3f endPoint = points[edgeIndexes[i].second];
+    float* centers = pointCenters.data();
+    float* vertices = edgePointVertices.data();
+    int pointIndex = 0, vertexIndex = 0;
+    for (const auto& edge : edges) {
         for (int j = 0; j < DIMENSION; j++) {
-            edgePointVertices[index] = (startPoint[j] + offset[j]) / OPENGL_SCALE;
-            if (j == 1) {
-                edgePointVertices[index] = -edgePointVertices[index];
-            }
-            index++;
+            centers[pointIndex++] = points[edge.first][j];
         }
-        for (int j = 0; j < DIMENSION; j++) {
-            edgePointVertices[index] = (endPoint[j] + offset[j]) / OPENGL_SCALE;
-            if (j == 1) {
-                edgePointVertices[index] = -edgePointVertices[index];
+        centers[pointIndex++] = edge.alphaMin;
+        centers[pointIndex++] = edge.alphaMax;
+        for (int end : { edge.first, edge.second }) {
+            for (int j = 0; j < DIMENSION; j++) {
+                vertices[vertexIndex++] = points[end][j];
             }
-            index++;
+            vertices[vertexIndex++] = edge.alphaMin;
+            vertices[vertexIndex++] = edge.alphaMax;
         }
     }
     return true;
@@ -226,52 +768,98 @@ int main()
 {
     cv::utils::logging::setLogLevel(cv::utils::logging::LOG_LEVEL_ERROR);
 
+#ifdef LU_BENCHMARK
+    for (int n : { 64, 200, 500, 1000, 2000 }) {
+        benchmarkLinearSystem(n);
+    }
+    return 0;
+#endif // LU_BENCHMARK
+
+#ifdef SDF_COMPARE
+    for (const char* imagePath : { "../../../../ImplicitFunction/resources/heart.png", "../../../../ImplicitFunction/resources/star.png" }) {
+        compareDistanceField(imagePath);
+    }
+    return 0;
+#endif // SDF_COMPARE
+
 #ifdef WRITE_MODE
     // 写入图片像素的隐函数值到文件
-    const char* imagePath_1 = "../../../../ImplicitFunction/resources/heart.png";
-    const char* imagePath_2 = "../../../../ImplicitFunction/resources/star.png";
     int rows, cols;
-    if (!writeImageValue(rows, cols, imagePath_1, imagePath_2)) {
+#ifdef VIDEO_MODE
+    // 视频模式：关键帧来自视频或图片序列的各帧
+    if (!writeSequenceValue(rows, cols, "../../../../ImplicitFunction/resources/sequence.mp4")) {
         std::cerr << "Implicit function interpolation failed." << std::endl;
         return -1;
     }
 #else
-    float weight = 0.0f, preWeight = 0.0f;
-    ifstream file1("../../../../ImplicitFunction/resources/image1_value.txt");
-    ifstream file2("../../../../ImplicitFunction/resources/image2_value.txt");
-    if (!file1 || !file2) {
-        std::cerr << "Failed to open file." << std::endl;
-        return false;
+    // 按插值顺序排列的关键帧图片，大小需要一致
+    std::vector<const char*> imagePaths = {
+        "../../../../ImplicitFunction/resources/heart.png",
+        "../../../../ImplicitFunction/resources/star.png"
+    };
+    if (!writeImageValue(rows, cols, imagePaths)) {
+        std::cerr << "Implicit function interpolation failed." << std::endl;
+        return -1;
     }
-    std::string line1, line2;
+#endif // VIDEO_MODE
+#else
+    float weight = 0.0f, preWeight = 0.0f;
+    bool sequenceModeEnabled = false, playing = false, splineEnabled = false;
+    // α-shape的半径，只影响着色器中的筛选
+    float alpha = ALPHA;
+    int playDirection = 1;
 
-    // 读取文件数据
+#ifdef COEFFICIENT_MODE
+    // 系数模式：依次读取image1_model.txt, image2_model.txt, ...，插值时直接由系数组合出隐函数，只在视口内求值
+    std::vector<ImplicitFunctionModel> models;
     int rows, cols;
-    for (int i = 0; i < 3; i++) {
-        std::getline(file1, line1);
-        std::getline(file2, line2);
-        if (i == 0) {
-            rows = std::stoi(line1);
+    for (int k = 1; ; k++) {
+        std::string filePath = "../../../../ImplicitFunction/resources/image" + std::to_string(k) + "_model.txt";
+        ImplicitFunctionModel model;
+        if (!readModelFile(filePath.c_str(), model)) {
+            break;
         }
-        else if (i == 1) {
-            cols = std::stoi(line1);
+        if (k == 1) {
+            rows = model.rows;
+            cols = model.cols;
+        }
+        else if (model.rows != rows || model.cols != cols) {
+            std::cerr << filePath << " has a different size from image1_model.txt" << std::endl;
+            return -1;
         }
+        models.push_back(std::move(model));
     }
-    int dataSize = ((rows / STEP + 1) * (cols / STEP + 1));    // 确保dataSize大小足够
-    float* fileData_1 = new float[dataSize];
-    float* fileData_2 = new float[dataSize];
-    int index = 0;
-    for (int x = 0; x < cols; x += STEP) {
-        for (int y = 0; y < rows; y += STEP) {
-            for (int z = 0; z <= 0; z += STEP) {
-                std::getline(file1, line1);
-                std::getline(file2, line2);
-                fileData_1[index] = std::stof(line1);
-                fileData_2[index] = std::stof(line2);
-                index++;
-            }
+    int fieldNum = models.size();
+    std::mutex regionMutex;
+    Eigen::Vector4f viewRegion(0.0f, 0.0f, static_cast<float>(cols), static_cast<float>(rows));
+#else
+    // 依次读取image1_value.txt, image2_value.txt, ...，直到文件不存在
+    std::vector<TiledField> fields;
+    int rows, cols;
+    for (int k = 1; ; k++) {
+        std::string filePath = "../../../../ImplicitFunction/resources/image" + std::to_string(k) + "_value.txt";
+        int fieldRows, fieldCols;
+        TiledField field;
+        if (!readFieldFile(filePath.c_str(), fieldRows, fieldCols, field)) {
+            break;
         }
+        if (k == 1) {
+            rows = fieldRows;
+            cols = fieldCols;
+        }
+        else if (fieldRows != rows || fieldCols != cols) {
+            std::cerr << filePath << " has a different size from image1_value.txt" << std::endl;
+            return -1;
+        }
+        fields.push_back(std::move(field));
     }
+    int fieldNum = fields.size();
+#endif // COEFFICIENT_MODE
+    if (fieldNum < 2) {
+        std::cerr << "Failed to open file." << std::endl;
+        return -1;
+    }
+    std::cout << "Loaded " << fieldNum << " fields" << std::endl;
 
     // glfw初始化
     glfwInit();
@@ -306,17 +894,249 @@ int main()
 
     // 得到OpenGL显示数据，并且使图像偏移到OpenGL窗口的中心位置，方便OpenGL显示
     float offset[DIMENSION] = { -static_cast<float>(cols) / 2, -static_cast<float>(rows) / 2, 0.0f };
-    vector<Eigen::Vector3f> actualPoints;
-    int actualPointSize = 0, edgePointSize = 0;
-    float* actualPointVertices = new float[MAX_ALLOC_SIZE];
-    float* edgePointVertices = new float[MAX_ALLOC_SIZE];
+    // 计算一帧的顶点数据
+    std::atomic<bool> splineWeights{ false };
+#ifdef ALLOC_DEBUG
+    std::atomic<long long> frameAllocations{ 0 };
+#endif // ALLOC_DEBUG
+    auto computeFrame = [&](float weight, const CancelToken& cancel, FrameData& frame) {
+#ifdef ALLOC_DEBUG
+        AllocationScope allocationScope{ frameAllocations };
+#endif // ALLOC_DEBUG
+        // 后台线程和预计算的各线程各用一份缓冲
+        thread_local FrameScratch scratch;
+        std::vector<float>& weights = scratch.weights;
+        keyframeWeights(weight, fieldNum, splineWeights, weights);
+        std::vector<Eigen::Vector3f>& points = scratch.points;
+        points.clear();
+#ifdef COEFFICIENT_MODE
+        ImplicitFunctionModel blended;
+        combineImplicitFunctions(weights, models, blended);
+        Eigen::Vector4f region;
+        {
+            std::lock_guard<std::mutex> lock(regionMutex);
+            region = viewRegion;
+        }
+        // 视口较长的一边分为COEFFICIENT_RESOLUTION格，放大后步长随之变小
+        float step = std::max(region[2] - region[0], region[3] - region[1]) / COEFFICIENT_RESOLUTION;
+        std::vector<Polyline> polylines;
+        if (step > 0.0f) {
+            getRegionZeroValuePoints(blended, region[0], region[1], region[2], region[3], step, polylines);
+        }
+        if (cancel.cancelled()) {
+            return false;
+        }
+        flattenPolylines(polylines, points);
+#else
+        if (!implicitFunctionInterpolation(weights, fields, points, scratch.interpolation, cancel)) {
+            return false;
+        }
+#endif // COEFFICIENT_MODE
+        // 在副本上原地求凸包，不打乱points的顺序；帧缓冲循环使用，副本的容量保留下来
+        frame.hull.assign(points.begin(), points.end());
+        frame.hull.resize(ConvexHullInPlace(frame.hull, scratch.hullSizes));
+#ifdef EDGE_MODE
+        return presentPointAndEdge(points, frame.pointCenterSize, frame.edgePointSize,
+            frame.pointCenters, frame.edgePointVertices, scratch);
+#else
+        frame.edgePointSize = 0;
+        return presentPoint(points, frame.pointCenterSize, frame.pointCenters);
+#endif // !EDGE_MODE
+    };
+#if defined(ALLOC_DEBUG) && !defined(COEFFICIENT_MODE)
+    // 稳态检查：同一组权重第二次计算时缓冲的容量都已足够，不应再分配内存，否则报错退出
+    // 系数模式的混合隐函数每帧都会重新组合，不做检查
+    {
+        FrameData checkFrame;
+        const float checkWeights[] = { 0.0f, 0.5f, 1.0f };
+        for (float weight : checkWeights) {
+            computeFrame(weight, CancelToken(), checkFrame);
+        }
+        for (float weight : checkWeights) {
+            computeFrame(weight, CancelToken(), checkFrame);
+            if (frameAllocations > 0) {
+                std::cerr << "Steady-state frame at weight " << weight << " allocated " << frameAllocations << " times" << std::endl;
+                glfwTerminate();
+                return -1;
+            }
+        }
+    }
+#endif // ALLOC_DEBUG
+    // 序列模式：权重量化为SEQUENCE_FRAMES帧，算过的帧保存在LRU缓存中，拖动和播放时直接取缓存
+    FrameCache frameCache(FRAME_CACHE_SIZE);
+    std::atomic<bool> sequenceMode{ false }, precomputeRequested{ false };
+    std::atomic<int> currentKey{ 0 };
+    auto cacheFrame = [&](int key, const CancelToken& cancel, FrameData& frame) {
+        if (!computeFrame(sequenceWeight(key), cancel, frame)) {
+            return false;
+        }
+        frameCache.put(key, std::make_shared<const CachedFrame>(frame));
+        return true;
+    };
+    // 预取用的帧缓冲，只在后台线程中使用
+    FrameData prefetchFrame;
+    // 插值和顶点计算在后台线程中进行，主循环只提交权重并取回计算完成的帧
+    InterpolationWorker worker([&](float weight, const CancelToken& cancel, FrameData& frame) {
+        if (!sequenceMode) {
+            return computeFrame(weight, cancel, frame);
+        }
+        int key = sequenceKey(weight);
+        currentKey = key;
+        if (auto cached = frameCache.get(key)) {
+            return cached->copyTo(frame);
+        }
+        return cacheFrame(key, cancel, frame);
+    }, [&](const CancelToken& cancel) {
+        if (!sequenceMode) {
+            return false;
+        }
+        // 预计算整个序列：各线程用自己的帧缓冲并行计算缓存中没有的帧，被取消后下次空闲时继续
+        if (precomputeRequested) {
+            std::vector<int> keys;
+            for (int key = 0; key < SEQUENCE_FRAMES; key++) {
+                if (!frameCache.contains(key)) {
+                    keys.push_back(key);
+                }
+            }
+#pragma omp parallel
+            {
+                FrameData scratch;
+#pragma omp for schedule(dynamic)
+                for (int k = 0; k < static_cast<int>(keys.size()); k++) {
+                    if (!cancel.cancelled()) {
+                        cacheFrame(keys[k], cancel, scratch);
+                    }
+                }
+            }
+            if (!cancel.cancelled()) {
+                precomputeRequested = false;
+            }
+            return true;
+        }
+        // 预取当前帧两侧PREFETCH_RADIUS以内的帧，由近及远，每次只算一帧以便尽快响应新的权重
+        // 缓存已满（发生淘汰）时停止预取，避免预取的帧互相淘汰
+        int center = currentKey;
+        for (int distance = 1; distance <= PREFETCH_RADIUS; distance++) {
+            for (int key : { center + distance, center - distance }) {
+                if (key >= 0 && key < SEQUENCE_FRAMES && !frameCache.contains(key)) {
+                    int evictions = frameCache.getEvictions();
+                    return cacheFrame(key, cancel, prefetchFrame) && frameCache.getEvictions() == evictions;
+                }
+            }
+        }
+        return false;
+    });
 
     // OpenGL对象定义
     Shader pointShader("../../../../ImplicitFunction/resources/Point.vert", "../../../../ImplicitFunction/resources/Point.frag");
     Shader edgeShader("../../../../ImplicitFunction/resources/Edge.vert", "../../../../ImplicitFunction/resources/Edge.frag");
-    unsigned int VBOs[2], VAOs[2];
-    glGenVertexArrays(2, VAOs);
-    glGenBuffers(2, VBOs);
+    // 点用实例化绘制：立方体网格和索引只上传一次，每个实例只有点的中心
+    std::vector<Eigen::Vector3f> cubeVertices;
+    std::vector<unsigned int> cubeIndices;
+    pointCubeMesh(cubeVertices, cubeIndices);
+    unsigned int cubeVBO, cubeEBO;
+    glGenBuffers(1, &cubeVBO);
+    glGenBuffers(1, &cubeEBO);
+    glBindBuffer(GL_ARRAY_BUFFER, cubeVBO);
+    glBufferData(GL_ARRAY_BUFFER, cubeVertices.size() * sizeof(Eigen::Vector3f), cubeVertices.data(), GL_STATIC_DRAW);
+    // 点的中心和边的端点通过顶点数据流上传，每段的容量从ARENA_INITIAL_SIZE开始，不够时增长
+    VertexStream pointStream(ARENA_INITIAL_SIZE), edgeStream(ARENA_INITIAL_SIZE);
+    std::cout << (pointStream.persistent() ? "Vertex streams: persistent mapping" : "Vertex streams: glMapBufferRange") << std::endl;
+    // 数据流的每一段对应一个VAO，绘制时绑定当前段的VAO；只在数据流重新创建时重新设置顶点属性
+    unsigned int pointVAOs[STREAM_SEGMENTS], edgeVAOs[STREAM_SEGMENTS];
+    glGenVertexArrays(STREAM_SEGMENTS, pointVAOs);
+    glGenVertexArrays(STREAM_SEGMENTS, edgeVAOs);
+    glBindVertexArray(pointVAOs[0]);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cubeEBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, cubeIndices.size() * sizeof(unsigned int), cubeIndices.data(), GL_STATIC_DRAW);
+    auto setupVertexArrays = [&]() {
+        for (int k = 0; k < STREAM_SEGMENTS; k++) {
+            glBindVertexArray(pointVAOs[k]);
+            glBindBuffer(GL_ARRAY_BUFFER, cubeVBO);
+            glVertexAttribPointer(0, DIMENSION, GL_FLOAT, GL_FALSE, DIMENSION * sizeof(float), (void*)0);
+            glEnableVertexAttribArray(0);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cubeEBO);
+            glBindBuffer(GL_ARRAY_BUFFER, pointStream.buffer);
+            glVertexAttribPointer(1, DIMENSION, GL_FLOAT, GL_FALSE, VERTEX_FLOATS * sizeof(float), (void*)pointStream.offset(k));
+            glEnableVertexAttribArray(1);
+            glVertexAttribDivisor(1, 1);
+#ifdef EDGE_MODE
+            glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, VERTEX_FLOATS * sizeof(float), (void*)(pointStream.offset(k) + DIMENSION * sizeof(float)));
+            glEnableVertexAttribArray(2);
+            glVertexAttribDivisor(2, 1);
+#endif // EDGE_MODE
+
+            glBindVertexArray(edgeVAOs[k]);
+            glBindBuffer(GL_ARRAY_BUFFER, edgeStream.buffer);
+            glVertexAttribPointer(0, DIMENSION, GL_FLOAT, GL_FALSE, VERTEX_FLOATS * sizeof(float), (void*)edgeStream.offset(k));
+            glEnableVertexAttribArray(0);
+#ifdef EDGE_MODE
+            glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, VERTEX_FLOATS * sizeof(float), (void*)(edgeStream.offset(k) + DIMENSION * sizeof(float)));
+            glEnableVertexAttribArray(1);
+#endif // EDGE_MODE
+        }
+        glBindVertexArray(0);
+    };
+    setupVertexArrays();
+#ifndef EDGE_MODE
+    // 没有α区间时着色器使用顶点属性的当前值，区间[0, FLT_MAX)使所有点都显示
+    glVertexAttrib2f(1, 0.0f, FLT_MAX);
+    glVertexAttrib2f(2, 0.0f, FLT_MAX);
+#endif // !EDGE_MODE
+    // 持久映射时帧缓冲池的第k帧关联数据流的第k段，后台线程直接写入GPU可见的内存，不需要复制：
+    // 帧归还给后台线程之前等待GPU用完这一段并关联上；新的一帧不在自己的段中时（第一次使用、超出段的容量后改用了自己的内存、
+    // 或在数据流增长前的旧缓冲中）复制一次再关联。不支持持久映射时新的一帧用upload()复制到环形缓冲的下一段
+    static_assert(FRAME_POOL_SIZE <= STREAM_SEGMENTS, "Each frame of the pool needs its own stream segment.");
+    auto releaseFrame = [&](FrameData& frame) {
+        if (pointStream.persistent() && edgeStream.persistent()) {
+            frame.pointCenters.attach(pointStream.acquire(frame.slot), pointStream.getSegmentSize());
+            frame.edgePointVertices.attach(edgeStream.acquire(frame.slot), edgeStream.getSegmentSize());
+        }
+    };
+    auto attachFrame = [](VertexStream& stream, int slot, VertexArena& arena, int size) {
+        if (stream.contains(slot, arena.data())) {
+            return;
+        }
+        arena.attach(stream.acquire(slot, arena.data(), size), stream.getSegmentSize());
+    };
+    // 当前绘制的帧、所在的段和数量，只有新的一帧到达时才更新和上传
+    const FrameData* drawnFrame = nullptr;
+    int pointSegment = 0, edgeSegment = 0, pointCount = 0, edgeVertexCount = 0;
+    // 当前帧的包围盒（加上点的大小）和上一次绘制时是否在视口中
+    Eigen::Vector4f frameBounds(FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX);
+    bool frameVisible = true;
+#ifdef GPU_MODE
+    // GPU模式：采样值只上传一次，片段着色器混合各形状并绘制等值线，改变权重只需要更新uniform
+    if (fieldNum > GPU_MAX_FIELDS) {
+        std::cerr << "GPU_MODE supports at most " << GPU_MAX_FIELDS << " fields." << std::endl;
+        return -1;
+    }
+    Shader fieldShader("../../../../ImplicitFunction/resources/Field.vert", "../../../../ImplicitFunction/resources/Field.frag");
+    unsigned int fieldTexture, fieldVBO, fieldVAO;
+    uploadFieldTexture(fields, fieldTexture);
+    // 覆盖采样网格的矩形，每个顶点为OpenGL坐标和图片坐标
+    float xMax = static_cast<float>((fields[0].xNum - 1) * STEP), yMax = static_cast<float>((fields[0].yNum - 1) * STEP);
+    float fieldVertices[4 * 5];
+    float corners[4][2] = { { 0.0f, 0.0f }, { xMax, 0.0f }, { 0.0f, yMax }, { xMax, yMax } };
+    for (int k = 0; k < 4; k++) {
+        fieldVertices[k * 5] = (corners[k][0] + offset[0]) / OPENGL_SCALE;
+        fieldVertices[k * 5 + 1] = -(corners[k][1] + offset[1]) / OPENGL_SCALE;
+        fieldVertices[k * 5 + 2] = 0.0f;
+        fieldVertices[k * 5 + 3] = corners[k][0];
+        fieldVertices[k * 5 + 4] = corners[k][1];
+    }
+    glGenVertexArrays(1, &fieldVAO);
+    glGenBuffers(1, &fieldVBO);
+    glBindVertexArray(fieldVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, fieldVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(fieldVertices), fieldVertices, GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    bool fillEnabled = false;
+    std::vector<float> gpuWeights;
+#endif // GPU_MODE
 
     // OpenGL主循环
     while (!glfwWindowShouldClose(window))
@@ -332,18 +1152,86 @@ int main()
         ImGui::Text("helloworld.");
         ImGui::InputFloat("image1 weight", &weight, 0.01f, 1.0f, "%.2f");
         ImGui::SameLine();
-        if (weight != preWeight && weight >= 0.0f && weight <= 1.0f) {
-            std::vector<Eigen::Vector3f> points;
-            implicitFunctionInterpolation(weight, rows, cols, fileData_1, fileData_2, points);
-            preWeight = weight;
+        // 多于两个形状时可以选择关键帧之间的插值方式，改变后缓存的帧失效
+        if (fieldNum > 2 && ImGui::Checkbox("spline", &splineEnabled)) {
+            splineWeights = splineEnabled;
+#ifndef GPU_MODE
+            frameCache.clear();
+            worker.post(preWeight);
+#endif // !GPU_MODE
+        }
 #ifdef EDGE_MODE
-            presentPointAndEdge(points, actualPointSize, edgePointSize, actualPointVertices, edgePointVertices, offset);
+        ImGui::SliderFloat("alpha", &alpha, 1.0f, 1000.0f, "%.1f", ImGuiSliderFlags_Logarithmic);
+#endif // EDGE_MODE
+#ifdef GPU_MODE
+        ImGui::Checkbox("fill", &fillEnabled);
 #else
-            presentPoint(points, actualPointSize, actualPointVertices, offset);
-#endif // !EDGE_MODE
+        if (ImGui::Checkbox("sequence mode", &sequenceModeEnabled)) {
+            sequenceMode = sequenceModeEnabled;
+            playing = false;
+        }
+        if (sequenceModeEnabled) {
+            if (ImGui::Button("precompute")) {
+                precomputeRequested = true;
+                worker.post(preWeight);
+            }
+            ImGui::SameLine();
+            ImGui::Checkbox("play", &playing);
+            // 播放时在0和1之间往返
+            if (playing) {
+                int key = sequenceKey(weight) + playDirection;
+                if (key < 0 || key >= SEQUENCE_FRAMES) {
+                    playDirection = -playDirection;
+                    key += 2 * playDirection;
+                }
+                weight = sequenceWeight(key);
+            }
+            weight = sequenceWeight(sequenceKey(weight));
+            ImGui::Text("cached frames: %d / %d (%.1f MB), hits: %d, misses: %d",
+                frameCache.count(), SEQUENCE_FRAMES, frameCache.size() / 1048576.0,
+                frameCache.getHits(), frameCache.getMisses());
+        }
+        ImGui::Text("vertex memory: %.1f / %.1f MB, high-water: %.1f MB",
+            vertexBudget().getUsed() / 1048576.0, vertexBudget().getLimit() / 1048576.0,
+            vertexBudget().getHighWater() / 1048576.0);
+#ifdef ALLOC_DEBUG
+        ImGui::Text("heap allocations in the last computed frame: %lld", frameAllocations.load());
+#endif // ALLOC_DEBUG
+        if (drawnFrame) {
+            ImGui::Text("convex hull: %d vertices, %s", static_cast<int>(drawnFrame->hull.size()),
+                frameVisible ? "visible" : "culled");
+        }
+#endif // GPU_MODE
+        if (weight != preWeight && weight >= 0.0f && weight <= 1.0f) {
+#ifndef GPU_MODE
+            worker.post(weight);
+#endif // !GPU_MODE
+            preWeight = weight;
         }
         ImGui::End();
 
+        FrameData* frame = worker.poll(releaseFrame);
+        if (frame && frame != drawnFrame) {
+            drawnFrame = frame;
+            pointCount = frame->pointCenterSize / VERTEX_FLOATS / sizeof(float);
+            edgeVertexCount = frame->edgePointSize / VERTEX_FLOATS / sizeof(float);
+            frameBounds = pointBounds(frame->hull) + Eigen::Vector4f(-POINT_SIZE, -POINT_SIZE, POINT_SIZE, POINT_SIZE);
+            bool pointGrown = pointStream.reserve(frame->pointCenterSize);
+            bool edgeGrown = edgeStream.reserve(frame->edgePointSize);
+            if (pointGrown || edgeGrown) {
+                setupVertexArrays();
+            }
+            if (pointStream.persistent() && edgeStream.persistent()) {
+                attachFrame(pointStream, frame->slot, frame->pointCenters, frame->pointCenterSize);
+                attachFrame(edgeStream, frame->slot, frame->edgePointVertices, frame->edgePointSize);
+                pointSegment = edgeSegment = frame->slot;
+            }
+            else {
+                pointSegment = pointStream.upload(frame->pointCenters.data(), frame->pointCenterSize);
+                edgeSegment = edgeStream.upload(frame->edgePointVertices.data(), frame->edgePointSize);
+            }
+        }
+
         processInput(window);
         glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -353,28 +1241,70 @@ int main()
         glm::mat4 projection = glm::mat4(1.0f);
         view = camera.GetViewMatrix();
         projection = glm::perspective(glm::radians(camera.Zoom), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 100.0f);
+        Eigen::Vector4f region = viewportRegion(projection, view, rows, cols, offset);
+        // 凸包的包围盒与视口没有交集时不绘制这一帧的点和边
+        frameVisible = frameBounds[0] <= region[2] && frameBounds[2] >= region[0]
+            && frameBounds[1] <= region[3] && frameBounds[3] >= region[1];
+#ifdef COEFFICIENT_MODE
+        // 视口变化超过其大小的1%时按新的范围重新计算，缓存的帧随之失效
+        bool regionChanged;
+        {
+            std::lock_guard<std::mutex> lock(regionMutex);
+            float tolerance = 0.01f * std::max(viewRegion[2] - viewRegion[0], viewRegion[3] - viewRegion[1]);
+            regionChanged = (region - viewRegion).cwiseAbs().maxCoeff() > std::max(tolerance, 1e-3f);
+            if (regionChanged) {
+                viewRegion = region;
+            }
+        }
+        if (regionChanged) {
+            frameCache.clear();
+            worker.post(preWeight);
+        }
+#endif // COEFFICIENT_MODE
 
-        pointShader.use();
-        pointShader.setMat4f("model", model);
-        pointShader.setMat4f("view", view);
-        pointShader.setMat4f("projection", projection);
-        glBindVertexArray(VAOs[0]);
-        glBindBuffer(GL_ARRAY_BUFFER, VBOs[0]);
-        glBufferData(GL_ARRAY_BUFFER, actualPointSize, actualPointVertices, GL_DYNAMIC_DRAW);
-        glVertexAttribPointer(0, DIMENSION, GL_FLOAT, GL_FALSE, DIMENSION * sizeof(float), (void*)0);
-        glEnableVertexAttribArray(0);
-        glDrawArrays(GL_TRIANGLES, 0, actualPointSize / DIMENSION / sizeof(float));
-
-        edgeShader.use();
-        edgeShader.setMat4f("model", model);
-        edgeShader.setMat4f("view", view);
-        edgeShader.setMat4f("projection", projection);
-        glBindVertexArray(VAOs[1]);
-        glBindBuffer(GL_ARRAY_BUFFER, VBOs[1]);
-        glBufferData(GL_ARRAY_BUFFER, edgePointSize, edgePointVertices, GL_DYNAMIC_DRAW);
-        glVertexAttribPointer(0, DIMENSION, GL_FLOAT, GL_FALSE, DIMENSION * sizeof(float), (void*)0);
-        glEnableVertexAttribArray(0);
-        glDrawArrays(GL_LINES, 0, edgePointSize / DIMENSION / sizeof(float));
+        if (frameVisible) {
+            pointShader.use();
+            pointShader.setMat4f("model", model);
+            pointShader.setMat4f("view", view);
+            pointShader.setMat4f("projection", projection);
+            pointShader.setVec3f("offset", glm::vec3(offset[0], offset[1], offset[2]));
+            pointShader.setFloat("scale", OPENGL_SCALE);
+            pointShader.setFloat("alpha", alpha);
+            glBindVertexArray(pointVAOs[pointSegment]);
+            glDrawElementsInstanced(GL_TRIANGLES, cubeIndices.size(), GL_UNSIGNED_INT, (void*)0, pointCount);
+
+            edgeShader.use();
+            edgeShader.setMat4f("model", model);
+            edgeShader.setMat4f("view", view);
+            edgeShader.setMat4f("projection", projection);
+            edgeShader.setVec3f("offset", glm::vec3(offset[0], offset[1], offset[2]));
+            edgeShader.setFloat("scale", OPENGL_SCALE);
+            edgeShader.setFloat("alpha", alpha);
+            glBindVertexArray(edgeVAOs[edgeSegment]);
+            glDrawArrays(GL_LINES, 0, edgeVertexCount);
+            // 记录GPU何时用完当前的段，之后写入这一段之前需要等待
+            if (drawnFrame) {
+                pointStream.fence(pointSegment);
+                edgeStream.fence(edgeSegment);
+            }
+        }
+
+#ifdef GPU_MODE
+        keyframeWeights(preWeight, fieldNum, splineEnabled, gpuWeights);
+        fieldShader.use();
+        fieldShader.setMat4f("model", model);
+        fieldShader.setMat4f("view", view);
+        fieldShader.setMat4f("projection", projection);
+        fieldShader.setFloatArray("weights", gpuWeights.data(), fieldNum);
+        fieldShader.setImage1i("fieldNum", fieldNum);
+        fieldShader.setImage1i("fill", fillEnabled);
+        fieldShader.setImage1i("fields", 0);
+        fieldShader.setFloat("gridStep", STEP);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, fieldTexture);
+        glBindVertexArray(fieldVAO);
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+#endif // GPU_MODE
 
         ImGui::Render();
         ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
@@ -382,20 +1312,27 @@ int main()
         glfwSwapBuffers(window);
         glfwPollEvents();
     }
-    glDeleteVertexArrays(2, VAOs);
-    glDeleteBuffers(2, VBOs);
+    worker.stop();
+    std::cout << "Vertex memory high-water: " << vertexBudget().getHighWater() / 1048576.0 << " MB" << std::endl;
+    pointStream.Delete();
+    edgeStream.Delete();
+    glDeleteVertexArrays(STREAM_SEGMENTS, pointVAOs);
+    glDeleteVertexArrays(STREAM_SEGMENTS, edgeVAOs);
+    glDeleteBuffers(1, &cubeVBO);
+    glDeleteBuffers(1, &cubeEBO);
     pointShader.Delete();
     edgeShader.Delete();
+#ifdef GPU_MODE
+    glDeleteVertexArrays(1, &fieldVAO);
+    glDeleteBuffers(1, &fieldVBO);
+    glDeleteTextures(1, &fieldTexture);
+    fieldShader.Delete();
+#endif // GPU_MODE
 
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
     glfwTerminate();
-
-    delete[] actualPointVertices;
-    delete[] edgePointVertices;
-    delete[] fileData_1;
-    delete[] fileData_2;
 #endif // !WRITE_MODE  
 
     return 0;
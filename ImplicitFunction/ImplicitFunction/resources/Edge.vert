@@ -1,11 +1,21 @@
 #version 330 core
 layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec2 aAlpha;
 
 uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
+uniform vec3 offset;
+uniform float scale;
+uniform float alpha;
 
 void main()
 {
-	gl_Position = projection * view * model * vec4(aPos, 1.0);
+	if (alpha < aAlpha.x || alpha >= aAlpha.y) {
+		gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+		return;
+	}
+	vec3 position = (aPos + offset) / scale;
+	position.y = -position.y;
+	gl_Position = projection * view * model * vec4(position, 1.0);
 }
\ No newline at end of file
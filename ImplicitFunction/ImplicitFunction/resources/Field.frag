@@ -0,0 +1,43 @@
+#version 330 core
+#define MAX_FIELDS 16
+in vec2 pixel;
+out vec4 FragColor;
+
+uniform sampler2DArray fields;
+uniform int fieldNum;
+uniform float weights[MAX_FIELDS];
+uniform float gridStep;
+uniform bool fill;
+
+float blendedValue(ivec2 texel)
+{
+	float value = 0.0;
+	for (int k = 0; k < fieldNum; k++) {
+		if (weights[k] != 0.0) {
+			value += weights[k] * texelFetch(fields, ivec3(texel, k), 0).r;
+		}
+	}
+	return value;
+}
+
+void main()
+{
+	vec2 grid = pixel.yx / gridStep;
+	ivec2 size = textureSize(fields, 0).xy;
+	ivec2 base = clamp(ivec2(floor(grid)), ivec2(0), size - 2);
+	vec2 t = clamp(grid - vec2(base), 0.0, 1.0);
+	float value = mix(
+		mix(blendedValue(base), blendedValue(base + ivec2(1, 0)), t.x),
+		mix(blendedValue(base + ivec2(0, 1)), blendedValue(base + ivec2(1, 1)), t.x),
+		t.y);
+	float width = fwidth(value);
+	if (abs(value) <= width) {
+		FragColor = vec4(0.3f, 1.0f, 1.0f, 1.0f);
+	}
+	else if (fill && value > 0.0) {
+		FragColor = vec4(0.15f, 0.5f, 0.5f, 1.0f);
+	}
+	else {
+		discard;
+	}
+}
\ No newline at end of file
@@ -88,6 +88,10 @@ public:
         glUniform1i(glGetUniformLocation(shaderProgram, name.c_str()), value);
     }
 
+    void setFloatArray(const string& name, const float* values, int count) const {
+        glUniform1fv(glGetUniformLocation(shaderProgram, name.c_str()), count, values);
+    }
+
 private:
     void checkCompileErrors(unsigned int shader, std::string type) {
         int success;
@@ -0,0 +1,221 @@
+#ifndef VERTEX_STREAM_H
+#define VERTEX_STREAM_H
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#define STREAM_SEGMENTS 3
+
+// glad只加载了OpenGL 3.3核心模式，glBufferStorage（GL_ARB_buffer_storage）需要自己加载
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+typedef void (APIENTRYP PFNBUFFERSTORAGEPROC)(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+
+// 顶点数据流：一个缓冲分为STREAM_SEGMENTS段，每段保存一帧的数据，每段用一个栅栏记录GPU何时用完该段
+// 支持GL_ARB_buffer_storage时整个缓冲持久映射，acquire()把一段映射的内存交给调用方（可以是其他线程）直接写入；
+// 否则用upload()通过不同步的glMapBufferRange把数据写入环形缓冲的下一段
+// 段的容量不够时用reserve()增长：持久映射的旧缓冲可能还在被其他线程写入，等它的每一段都重新acquire()之后才删除
+class VertexStream
+{
+public:
+    unsigned int buffer = 0;
+
+    VertexStream(GLsizeiptr segmentSize) {
+        create(segmentSize);
+    }
+
+    VertexStream(const VertexStream&) = delete;
+    VertexStream& operator=(const VertexStream&) = delete;
+
+    bool persistent() const {
+        return mapped != nullptr;
+    }
+
+    GLsizeiptr offset(int segment) const {
+        return segment * segmentSize;
+    }
+
+    GLsizeiptr getSegmentSize() const {
+        return segmentSize;
+    }
+
+    // 持久映射时data是否为当前缓冲第segment段的内存
+    bool contains(int segment, const void* data) const {
+        return mapped && data == mapped + offset(segment);
+    }
+
+    // 持久映射时把第segment段交给调用方写入：等待GPU用完这一段，先把data的size字节（可以在旧缓冲中）复制进来，
+    // 返回这一段的内存，容量为getSegmentSize()；调用方之后不再使用旧缓冲中的第segment段，旧缓冲的每一段都不再使用时删除
+    float* acquire(int segment, const void* data = nullptr, GLsizeiptr size = 0) {
+        wait(segment);
+        if (data && size > 0) {
+            memcpy(mapped + offset(segment), data, std::min(size, segmentSize));
+        }
+        for (size_t k = 0; k < retired.size();) {
+            retired[k].pending &= ~(1u << segment);
+            if (retired[k].pending == 0) {
+                destroy(retired[k]);
+                retired.erase(retired.begin() + k);
+            }
+            else {
+                k++;
+            }
+        }
+        return reinterpret_cast<float*>(mapped + offset(segment));
+    }
+
+    // 等待GPU用完第segment段
+    void wait(int segment) {
+        waitSync(fences[segment]);
+    }
+
+    // 在读取第segment段的绘制命令之后调用
+    void fence(int segment) {
+        if (fences[segment]) {
+            glDeleteSync(fences[segment]);
+        }
+        fences[segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+
+    // 等待GPU用完所有段后解除映射并删除缓冲（包括增长前的旧缓冲），需要在其他线程停止写入、OpenGL上下文销毁之前调用
+    void Delete() {
+        for (auto& storage : retired) {
+            destroy(storage);
+        }
+        retired.clear();
+        Storage storage = { buffer, mapped };
+        std::copy(fences, fences + STREAM_SEGMENTS, storage.fences);
+        destroy(storage);
+        std::fill(fences, fences + STREAM_SEGMENTS, nullptr);
+        mapped = nullptr;
+        buffer = 0;
+    }
+
+    // 保证每段至少能容纳size字节，不够时按2倍增长并重新创建缓冲，返回缓冲是否重新创建（需要重新设置顶点属性）
+    // 持久映射时旧缓冲保持映射，直到它的每一段都重新acquire()
+    bool reserve(GLsizeiptr size) {
+        if (size <= segmentSize) {
+            return false;
+        }
+        GLsizeiptr newSize = segmentSize;
+        while (newSize < size) {
+            newSize *= 2;
+        }
+        if (mapped) {
+            Storage storage = { buffer, mapped };
+            std::copy(fences, fences + STREAM_SEGMENTS, storage.fences);
+            storage.pending = (1u << STREAM_SEGMENTS) - 1;
+            retired.push_back(storage);
+            std::fill(fences, fences + STREAM_SEGMENTS, nullptr);
+            mapped = nullptr;
+            buffer = 0;
+        }
+        else {
+            Delete();
+        }
+        create(newSize);
+        return true;
+    }
+
+    // 非持久映射时把size字节的数据写入环形缓冲的下一段，返回写入的段
+    int upload(const void* data, GLsizeiptr size) {
+        next = (next + 1) % STREAM_SEGMENTS;
+        wait(next);
+        if (size > segmentSize) {
+            std::cerr << "Vertex stream segment is too small." << std::endl;
+            size = segmentSize;
+        }
+        if (size <= 0) {
+            return next;
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        void* target = glMapBufferRange(GL_ARRAY_BUFFER, offset(next), size,
+            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+        if (target) {
+            memcpy(target, data, size);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+        }
+        return next;
+    }
+
+private:
+    // 一个缓冲及其映射和栅栏，pending的第k位表示第k段还可能被使用
+    struct Storage {
+        unsigned int buffer = 0;
+        char* mapped = nullptr;
+        GLsync fences[STREAM_SEGMENTS] = {};
+        unsigned int pending = 0;
+    };
+
+    GLsizeiptr segmentSize = 0;
+    char* mapped = nullptr;
+    GLsync fences[STREAM_SEGMENTS] = {};
+    int next = STREAM_SEGMENTS - 1;
+    // 增长前的持久映射的缓冲
+    std::vector<Storage> retired;
+
+    // 等待栅栏之前的命令执行完并删除栅栏
+    static void waitSync(GLsync& sync) {
+        if (!sync) {
+            return;
+        }
+        while (true) {
+            GLenum result = glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+            if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED || result == GL_WAIT_FAILED) {
+                break;
+            }
+        }
+        glDeleteSync(sync);
+        sync = nullptr;
+    }
+
+    // 等待GPU用完缓冲的所有段后解除映射并删除
+    static void destroy(Storage& storage) {
+        for (GLsync& sync : storage.fences) {
+            waitSync(sync);
+        }
+        if (!storage.buffer) {
+            return;
+        }
+        if (storage.mapped) {
+            glBindBuffer(GL_ARRAY_BUFFER, storage.buffer);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+        }
+        glDeleteBuffers(1, &storage.buffer);
+    }
+
+    void create(GLsizeiptr segmentSize) {
+        this->segmentSize = segmentSize;
+        glGenBuffers(1, &buffer);
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        PFNBUFFERSTORAGEPROC bufferStorage = nullptr;
+        if (glfwExtensionSupported("GL_ARB_buffer_storage")) {
+            bufferStorage = (PFNBUFFERSTORAGEPROC)glfwGetProcAddress("glBufferStorage");
+        }
+        if (bufferStorage) {
+            // 增长后要从旧缓冲中把帧复制出来，所以也需要读
+            GLbitfield flags = GL_MAP_READ_BIT | GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            bufferStorage(GL_ARRAY_BUFFER, segmentSize * STREAM_SEGMENTS, nullptr, flags);
+            mapped = static_cast<char*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, segmentSize * STREAM_SEGMENTS, flags));
+            if (!mapped) {
+                // 不可变的缓冲不能再用glBufferData重新分配
+                glDeleteBuffers(1, &buffer);
+                glGenBuffers(1, &buffer);
+                glBindBuffer(GL_ARRAY_BUFFER, buffer);
+            }
+        }
+        if (!mapped) {
+            glBufferData(GL_ARRAY_BUFFER, segmentSize * STREAM_SEGMENTS, nullptr, GL_STREAM_DRAW);
+        }
+    }
+};
+
+#endif
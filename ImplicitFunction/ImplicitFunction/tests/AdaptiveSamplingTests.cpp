@@ -0,0 +1,76 @@
+﻿#define DIMENSION 3
+#define MAX_MATRIX_DIMENSION 200
+
+#include "../algorithm/AdaptiveSampling.hpp"
+#include "TestUtility.hpp"
+#include <Eigen/Dense>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+// 中心(500, 300)的五瓣星形：45个边界约束和45个向内的法向约束
+void starModel(ImplicitFunctionModel& model) {
+	model.rows = 600;
+	model.cols = 1000;
+	for (int k = 0; k < 45; k++) {
+		float angle = 2.0f * static_cast<float>(EIGEN_PI) * k / 45;
+		float radius = 150 + 40 * std::cos(5 * angle);
+		model.constraints.emplace_back(Eigen::Vector3f(500 + radius * std::cos(angle), 300 + radius * std::sin(angle), 0), 0.0f);
+		model.constraints.emplace_back(Eigen::Vector3f(500 + (radius - 4) * std::cos(angle), 300 + (radius - 4) * std::sin(angle), 0), 1.0f);
+	}
+	solveImplicitEquation(model.constraints, model.weights, model.P0, model.P);
+}
+
+size_t pointCount(const std::vector<Polyline>& polylines) {
+	size_t count = 0;
+	for (const auto& polyline : polylines) {
+		count += polyline.points.size();
+	}
+	return count;
+}
+
+// 自适应采样得到与逐点采样后marching squares相同的零值折线，求值次数少得多
+void testDenseZeroSet(const ImplicitFunctionModel& model) {
+	std::vector<float> field;
+	sampleImplicitFunction(model, field);
+	int xNum = (model.cols + STEP - 1) / STEP, yNum = (model.rows + STEP - 1) / STEP;
+	std::vector<Polyline> dense;
+	marchingSquares([&](int i, int j) { return field[i * yNum + j]; }, xNum, yNum, STEP, dense);
+
+	std::vector<Polyline> adaptive;
+	AdaptiveStatistics statistics;
+	adaptiveSampleImplicitFunction(model, adaptive, &statistics);
+	check(adaptive.size() == dense.size(), "adaptive sampling gives " + std::to_string(adaptive.size())
+		+ " polylines, dense sampling gives " + std::to_string(dense.size()));
+	check(pointCount(adaptive) == pointCount(dense), "adaptive sampling gives " + std::to_string(pointCount(adaptive))
+		+ " zero points, dense sampling gives " + std::to_string(pointCount(dense)));
+	for (const auto& polyline : adaptive) {
+		check(polyline.closed, "the star should give a closed polyline");
+	}
+	// 每个零值点在逐点采样的结果中都有对应的点；自适应采样用implicitFunctionValueAndGradient()求值，
+	// 与implicitFunctionValue()的舍入误差在|f|很小的网格点上会放大为插值位置的微小差异
+	float maxDistance = 0.0f;
+	for (const auto& polyline : adaptive) {
+		for (const auto& point : polyline.points) {
+			float nearest = std::numeric_limits<float>::max();
+			for (const auto& other : dense) {
+				for (const auto& densePoint : other.points) {
+					nearest = std::min(nearest, (point - densePoint).norm());
+				}
+			}
+			maxDistance = std::max(maxDistance, nearest);
+		}
+	}
+	check(maxDistance < 0.05f * STEP, "adaptive zero point is " + std::to_string(maxDistance) + " away from the dense zero set");
+	check(statistics.evaluations > 0 && statistics.evaluations < static_cast<int>(field.size()) / 4,
+		"adaptive sampling evaluates " + std::to_string(statistics.evaluations) + " of " + std::to_string(field.size()) + " samples");
+	check(statistics.leafCells > 0, "adaptive sampling should refine some cells down to one grid step");
+}
+
+int main() {
+	ImplicitFunctionModel model;
+	starModel(model);
+	testDenseZeroSet(model);
+	return testResult();
+}
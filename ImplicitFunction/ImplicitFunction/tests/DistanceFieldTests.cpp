@@ -0,0 +1,51 @@
+﻿#define DIMENSION 3
+#define MAX_MATRIX_DIMENSION 200
+
+#include "../algorithm/DistanceField.hpp"
+#include "TestUtility.hpp"
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <string>
+#include <vector>
+
+void testSignedDistanceField() {
+	// 100 × 100的图片中的正方形，采样点的值为到边界的有符号距离除以OFFSET，内部为正
+	int rows = 100, cols = 100;
+	std::vector<Eigen::Vector2f> contour = {
+		Eigen::Vector2f(20.5f, 20.5f), Eigen::Vector2f(80.5f, 20.5f), Eigen::Vector2f(80.5f, 80.5f), Eigen::Vector2f(20.5f, 80.5f)
+	};
+	std::vector<float> field;
+	check(signedDistanceField(contour, rows, cols, field), "signedDistanceField() failed on a square");
+	int xNum = (cols + STEP - 1) / STEP, yNum = (rows + STEP - 1) / STEP;
+	check(field.size() == static_cast<size_t>(xNum) * yNum, "field has the wrong size");
+	if (field.size() != static_cast<size_t>(xNum) * yNum) {
+		return;
+	}
+	float maxError = 0.0f;
+	int signErrors = 0;
+	for (int i = 0; i < xNum; i++) {
+		for (int j = 0; j < yNum; j++) {
+			Eigen::Vector2f point(i * STEP, j * STEP);
+			float distance = FLT_MAX;
+			for (size_t k = 0; k < contour.size(); k++) {
+				distance = std::min(distance, segmentDistance(point, contour[k], contour[(k + 1) % contour.size()]));
+			}
+			bool inside = point.x() > 20.5f && point.x() < 80.5f && point.y() > 20.5f && point.y() < 80.5f;
+			float value = field[i * yNum + j] * OFFSET;
+			signErrors += (value > 0.0f) != inside;
+			maxError = std::max(maxError, std::abs(std::abs(value) - distance));
+		}
+	}
+	check(signErrors == 0, std::to_string(signErrors) + " samples have the wrong sign");
+	check(maxError < 1e-3f, "distance error " + std::to_string(maxError) + " is too large");
+
+	std::vector<Eigen::Vector2f> line = { Eigen::Vector2f(0, 0), Eigen::Vector2f(1, 1) };
+	check(!signedDistanceField(line, rows, cols, field), "a contour with less than 3 points should be rejected");
+}
+
+int main() {
+	testSignedDistanceField();
+	return testResult();
+}
@@ -0,0 +1,73 @@
+﻿#include "../algorithm/FrameCache.hpp"
+#include "TestUtility.hpp"
+#include <memory>
+#include <string>
+
+// 一帧有floats个点坐标、没有边，坐标都等于value
+std::shared_ptr<const CachedFrame> frameOf(int floats, float value) {
+	FrameData frame;
+	frame.pointCenters.reserve(floats * sizeof(float));
+	for (int i = 0; i < floats; i++) {
+		frame.pointCenters.data()[i] = value;
+	}
+	frame.pointCenterSize = floats * sizeof(float);
+	frame.edgePointSize = 0;
+	return std::make_shared<const CachedFrame>(frame);
+}
+
+// 权重量化到最近的一帧，超出[0, 1]的权重取两端的帧
+void testSequenceKey() {
+	bool roundTrip = true;
+	for (int key = 0; key < SEQUENCE_FRAMES; key++) {
+		roundTrip &= sequenceKey(sequenceWeight(key)) == key;
+	}
+	check(roundTrip, "sequenceKey(sequenceWeight(key)) should give key back");
+	check(sequenceKey(-0.5f) == 0 && sequenceKey(1.5f) == SEQUENCE_FRAMES - 1, "weights outside [0, 1] should be clamped");
+	check(sequenceKey(0.4f / (SEQUENCE_FRAMES - 1)) == 0 && sequenceKey(0.6f / (SEQUENCE_FRAMES - 1)) == 1, "weights should round to the nearest frame");
+}
+
+// 缓存的帧复制回帧缓冲后顶点数据和大小不变
+void testCopy() {
+	auto cached = frameOf(6, 2.5f);
+	FrameData frame;
+	check(cached->copyTo(frame), "copying a cached frame within the budget failed");
+	check(frame.pointCenterSize == 6 * sizeof(float) && frame.edgePointSize == 0, "copied frame has the wrong size");
+	check(frame.pointCenters.data()[0] == 2.5f && frame.pointCenters.data()[5] == 2.5f, "copied frame has the wrong vertices");
+	check(cached->bytes() == 6 * sizeof(float), "CachedFrame::bytes() should count only the vertices in use");
+}
+
+// 超过容量时淘汰最久未使用的帧，get()刷新帧的使用时间，重复put()替换原来的帧
+void testEviction() {
+	const int floats = 100;
+	const size_t frameBytes = floats * sizeof(float);
+	FrameCache cache(frameBytes * 3);
+	for (int key = 0; key < 3; key++) {
+		cache.put(key, frameOf(floats, static_cast<float>(key)));
+	}
+	check(cache.count() == 3 && cache.size() == frameBytes * 3 && cache.getEvictions() == 0, "three frames should fit without eviction");
+	check(cache.get(0) != nullptr, "frame 0 should be cached");
+	cache.put(3, frameOf(floats, 3.0f));
+	check(cache.getEvictions() == 1 && cache.count() == 3, "putting a fourth frame should evict one frame");
+	check(!cache.contains(1), "the least recently used frame 1 should be evicted");
+	check(cache.contains(0) && cache.contains(2) && cache.contains(3), "recently used frames should stay cached");
+
+	cache.put(2, frameOf(floats / 2, 20.0f));
+	check(cache.count() == 3 && cache.size() == frameBytes * 5 / 2, "replacing a frame should update the cache size");
+	auto replaced = cache.get(2);
+	check(replaced && replaced->pointCenters[0] == 20.0f, "replacing a frame should keep the new data");
+	check(cache.get(1) == nullptr, "an evicted frame should miss");
+	check(cache.getHits() == 2 && cache.getMisses() == 1, "hits and misses are counted wrongly: " + std::to_string(cache.getHits())
+		+ " hits, " + std::to_string(cache.getMisses()) + " misses");
+
+	// 比容量还大的帧淘汰其余所有帧，但自身保留
+	cache.put(4, frameOf(floats * 4, 4.0f));
+	check(cache.count() == 1 && cache.contains(4), "a frame larger than the cache should replace every other frame");
+	check(cache.getEvictions() == 4, "evictions are counted wrongly: " + std::to_string(cache.getEvictions()));
+}
+
+int main() {
+	testSequenceKey();
+	testCopy();
+	testEviction();
+	return testResult();
+}
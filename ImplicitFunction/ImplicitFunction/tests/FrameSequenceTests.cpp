@@ -0,0 +1,70 @@
+﻿#define DIMENSION 3
+#define MAX_MATRIX_DIMENSION 200
+
+#include "../algorithm/FrameSequence.hpp"
+#include "TestUtility.hpp"
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+// 边界反转并旋转后再对齐，得到与原来相同的顺序
+void testAlignContour() {
+	std::vector<Eigen::Vector2f> circle;
+	for (int i = 0; i < 36; i++) {
+		float angle = i * 2.0f * static_cast<float>(EIGEN_PI) / 36;
+		circle.emplace_back(50.0f + 20.0f * std::cos(angle), 50.0f + 20.0f * std::sin(angle));
+	}
+	float area = signedArea(circle);
+	std::vector<Eigen::Vector2f> contour(circle.rbegin(), circle.rend());
+	std::rotate(contour.begin(), contour.begin() + 11, contour.end());
+	float reversedArea = -area;
+	alignContour(contour, reversedArea, area, circle[5] + Eigen::Vector2f(0.5f, 0.5f));
+	std::rotate(circle.begin(), circle.begin() + 5, circle.end());
+	check(contour == circle && reversedArea == area, "aligned contour should follow the previous orientation and start nearest the anchor");
+}
+
+// 逐帧旋转的椭圆：第一帧取约束点并记下相对位置，之后每帧对齐边界后在相同位置取点，
+// 点数不变，对应点的移动不超过椭圆上的点因旋转移动的距离
+void testTrackedSampling() {
+	int rows = 160, cols = 200;
+	float a = 60.0f, b = 35.0f, step = 3.0f * static_cast<float>(EIGEN_PI) / 180.0f;
+	std::vector<float> positions;
+	std::vector<Eigen::Vector2f> previous;
+	float preArea = 0.0f, maxMove = 0.0f;
+	int countChanges = 0;
+	for (int frame = 0; frame < 10; frame++) {
+		float c = std::cos(frame * step), s = std::sin(frame * step);
+		std::vector<Eigen::Vector2f> contour;
+		float area = traceBoundary([&](int y, int x) {
+			float u = c * (x - 100.0f) + s * (y - 80.0f), v = -s * (x - 100.0f) + c * (y - 80.0f);
+			return 50.0f * (1.0f - (u * u) / (a * a) - (v * v) / (b * b));
+		}, rows, cols, -50.0f, contour);
+		std::vector<Eigen::Vector2f> boundaryPoints, normalPoints;
+		if (positions.empty()) {
+			contourConstraintPoints(contour, area, boundaryPoints, normalPoints);
+			closedPolylinePositions(boundaryPoints, positions);
+		}
+		else {
+			alignContour(contour, area, preArea, previous[0]);
+			sampleClosedPolyline(contour, positions, boundaryPoints);
+			countChanges += boundaryPoints.size() != previous.size();
+			for (size_t i = 0; i < std::min(boundaryPoints.size(), previous.size()); i++) {
+				maxMove = std::max(maxMove, (boundaryPoints[i] - previous[i]).norm());
+			}
+		}
+		previous = boundaryPoints;
+		preArea = area;
+	}
+	check(std::is_sorted(positions.begin(), positions.end()) && positions.front() == 0.0f && positions.back() < 1.0f,
+		"sample positions should increase within [0, 1)");
+	check(countChanges == 0, "constraint count changed in " + std::to_string(countChanges) + " frames");
+	check(maxMove < a * step + 1.0f, "tracked samples moved up to " + std::to_string(maxMove) + " pixels between frames");
+}
+
+int main() {
+	testAlignContour();
+	testTrackedSampling();
+	return testResult();
+}
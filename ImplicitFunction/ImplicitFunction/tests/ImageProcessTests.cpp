@@ -0,0 +1,135 @@
+﻿#define DIMENSION 3
+#define MAX_MATRIX_DIMENSION 200
+
+#include "../algorithm/ImageProcess.hpp"
+#include "TestUtility.hpp"
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+// 闭合折线，按弧长每隔spacing取一个点
+std::vector<Eigen::Vector2f> densePolygon(const std::vector<Eigen::Vector2f>& vertices, float spacing) {
+	std::vector<Eigen::Vector2f> contour;
+	int n = vertices.size();
+	for (int i = 0; i < n; i++) {
+		Eigen::Vector2f a = vertices[i], b = vertices[(i + 1) % n];
+		int steps = std::max(1, static_cast<int>(std::ceil((b - a).norm() / spacing)));
+		for (int k = 0; k < steps; k++) {
+			contour.push_back(a + (b - a) * (static_cast<float>(k) / steps));
+		}
+	}
+	return contour;
+}
+
+// 五角星、圆和带噪声的不规则形状
+std::vector<std::vector<Eigen::Vector2f>> testContours() {
+	std::vector<Eigen::Vector2f> star, circle, blob;
+	for (int k = 0; k < 10; k++) {
+		float angle = static_cast<float>(EIGEN_PI) * k / 5.0f;
+		float radius = k % 2 ? 40.0f : 100.0f;
+		star.emplace_back(200.0f + radius * std::sin(angle), 200.0f - radius * std::cos(angle));
+	}
+	std::mt19937 random(17);
+	std::uniform_real_distribution<float> noise(-1.5f, 1.5f);
+	for (int k = 0; k < 600; k++) {
+		float angle = 2.0f * static_cast<float>(EIGEN_PI) * k / 600.0f;
+		circle.emplace_back(300.0f + 95.0f * std::cos(angle), 300.0f + 95.0f * std::sin(angle));
+		float radius = 120.0f + 30.0f * std::sin(3.0f * angle) + noise(random);
+		blob.emplace_back(300.0f + radius * std::cos(angle), 300.0f + radius * std::sin(angle));
+	}
+	return { densePolygon(star, 0.5f), circle, blob };
+}
+
+// 相邻两个采样点之间（循环顺序）的轮廓点到两点连线的最大距离
+float samplingError(const std::vector<Eigen::Vector2f>& contour, const std::vector<int>& indexes) {
+	int n = contour.size(), m = indexes.size();
+	float error = 0.0f;
+	for (int k = 0; k < m; k++) {
+		int from = indexes[k], to = indexes[(k + 1) % m];
+		const Eigen::Vector2f& a = contour[from];
+		const Eigen::Vector2f& b = contour[to];
+		for (int i = (from + 1) % n; i != to; i = (i + 1) % n) {
+			error = std::max(error, segmentDistance(contour[i], a, b));
+		}
+	}
+	return error;
+}
+
+// 采样点按轮廓的循环顺序排列，各不相同
+bool cyclicOrder(const std::vector<int>& indexes) {
+	int descents = 0;
+	for (size_t k = 0; k < indexes.size(); k++) {
+		descents += indexes[(k + 1) % indexes.size()] <= indexes[k];
+	}
+	return descents == 1;
+}
+
+// 点数不超过上限时边界误差不超过容差，放大容差时点数不超过上限、误差不超过放大后的容差
+void testAdaptiveSampleIndexes() {
+	std::vector<std::vector<Eigen::Vector2f>> contours = testContours();
+	const char* names[] = { "star", "circle", "blob" };
+	for (size_t c = 0; c < contours.size(); c++) {
+		const std::vector<Eigen::Vector2f>& contour = contours[c];
+		std::string name = names[c];
+		int previousSize = 0;
+		for (float tolerance : { 3.0f, 1.0f, 0.25f }) {
+			std::vector<int> indexes;
+			adaptiveSampleIndexes(contour, tolerance, static_cast<int>(contour.size()), indexes);
+			float error = samplingError(contour, indexes);
+			check(cyclicOrder(indexes), name + ": samples should follow the contour order");
+			check(error <= tolerance * (1.0f + 1e-4f), name + ": boundary error " + std::to_string(error) + " exceeds tolerance " + std::to_string(tolerance));
+			check(static_cast<int>(indexes.size()) >= previousSize, name + ": a smaller tolerance should not remove samples");
+			previousSize = indexes.size();
+		}
+
+		int maxNum = 12;
+		std::vector<float> significance;
+		int start;
+		contourSignificance(contour, significance, start);
+		std::nth_element(significance.begin(), significance.begin() + maxNum, significance.end(), std::greater<float>());
+		float raised = significance[maxNum];
+		std::vector<int> indexes;
+		adaptiveSampleIndexes(contour, 0.25f, maxNum, indexes);
+		float error = samplingError(contour, indexes);
+		check(static_cast<int>(indexes.size()) <= maxNum && indexes.size() >= 3,
+			name + ": capped sampling should keep at most " + std::to_string(maxNum) + " points, got " + std::to_string(indexes.size()));
+		check(cyclicOrder(indexes), name + ": capped samples should follow the contour order");
+		check(error <= raised * (1.0f + 1e-4f), name + ": capped boundary error " + std::to_string(error) + " exceeds the raised tolerance " + std::to_string(raised));
+	}
+
+	// 五角星的10个顶点在容差为1时都要保留，直边上不需要其他的点
+	std::vector<int> indexes;
+	adaptiveSampleIndexes(contours[0], 1.0f, static_cast<int>(contours[0].size()), indexes);
+	check(indexes.size() == 10, "star should be sampled at its 10 corners, got " + std::to_string(indexes.size()) + " points");
+}
+
+// 顶点的相对弧长位置在折线加密之后仍取回原来的顶点，均匀重新采样得到各边的中点
+void testClosedPolylinePositions() {
+	std::vector<Eigen::Vector2f> square = { { 0, 0 }, { 10, 0 }, { 10, 10 }, { 0, 10 } };
+	std::vector<float> positions;
+	closedPolylinePositions(square, positions);
+	check(positions == std::vector<float>({ 0.0f, 0.25f, 0.5f, 0.75f }), "square vertices should be at quarter positions");
+
+	std::vector<Eigen::Vector2f> dense = densePolygon(square, 0.3f), sampled;
+	sampleClosedPolyline(dense, positions, sampled);
+	float error = 0.0f;
+	for (size_t i = 0; i < sampled.size(); i++) {
+		error = std::max(error, (sampled[i] - square[i]).norm());
+	}
+	check(sampled.size() == square.size() && error < 1e-4f, "sampling a denser square at the vertex positions should give the vertices, error " + std::to_string(error));
+
+	std::vector<Eigen::Vector2f> resampled;
+	resampleClosedPolyline(square, 8, resampled);
+	check(resampled.size() == 8 && resampled[1].isApprox(Eigen::Vector2f(5, 0)) && resampled[7].isApprox(Eigen::Vector2f(0, 5)),
+		"uniform resampling of a square should hit the edge midpoints");
+}
+
+int main() {
+	testAdaptiveSampleIndexes();
+	testClosedPolylinePositions();
+	return testResult();
+}
@@ -0,0 +1,106 @@
+﻿#define DIMENSION 3
+#define MAX_MATRIX_DIMENSION 200
+
+#include "../algorithm/ImplicitFunction.hpp"
+#include "TestUtility.hpp"
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// 中心(150, 100)、半轴60和40的椭圆：40个边界约束和40个向内的法向约束
+void ellipseModel(ImplicitFunctionModel& model) {
+	model.rows = 200;
+	model.cols = 300;
+	for (int k = 0; k < 40; k++) {
+		float angle = 2.0f * static_cast<float>(EIGEN_PI) * k / 40;
+		model.constraints.emplace_back(Eigen::Vector3f(150 + 60 * std::cos(angle), 100 + 40 * std::sin(angle), 0), 0.0f);
+		model.constraints.emplace_back(Eigen::Vector3f(150 + 56 * std::cos(angle), 100 + 36 * std::sin(angle), 0), 1.0f);
+	}
+	solveImplicitEquation(model.constraints, model.weights, model.P0, model.P);
+}
+
+// 解析梯度与中心差分一致
+void testGradient(const ImplicitFunctionModel& model) {
+	const Eigen::Vector3f points[] = { Eigen::Vector3f(150, 100, 0), Eigen::Vector3f(205, 110, 0), Eigen::Vector3f(40, 30, 0) };
+	for (const auto& point : points) {
+		Eigen::Vector3f gradient;
+		float value = implicitFunctionValueAndGradient(point, model, gradient);
+		check(std::abs(value - implicitFunctionValue(point, model)) < 1e-4f, "value from implicitFunctionValueAndGradient() differs");
+		float h = 0.5f;
+		for (int d = 0; d < 2; d++) {
+			Eigen::Vector3f offset = Eigen::Vector3f::Zero();
+			offset[d] = h;
+			float difference = (implicitFunctionValue(point + offset, model) - implicitFunctionValue(point - offset, model)) / (2 * h);
+			check(std::abs(difference - gradient[d]) < 1e-2f * std::max(1.0f, std::abs(difference)),
+				"analytic gradient differs from the central difference: " + std::to_string(gradient[d]) + " vs " + std::to_string(difference));
+		}
+	}
+}
+
+// CONTOUR_STEP粗网格上的零值点投影后|f| <= 9e-4（投影前约为5e-2），法向量为单位长度并指向形状外
+void testRefinedZeroSet(const ImplicitFunctionModel& model) {
+	std::vector<Polyline> polylines;
+	std::vector<std::vector<Eigen::Vector3f>> normals;
+	getRefinedZeroValuePoints(model, CONTOUR_STEP, polylines, &normals);
+	check(polylines.size() == 1 && polylines[0].closed, "an ellipse should give one closed polyline");
+	check(normals.size() == polylines.size(), "one normal list per polyline expected");
+	float maxValue = 0.0f;
+	for (size_t i = 0; i < polylines.size() && i < normals.size(); i++) {
+		check(normals[i].size() == polylines[i].points.size(), "one normal per point expected");
+		for (size_t k = 0; k < polylines[i].points.size() && k < normals[i].size(); k++) {
+			const Eigen::Vector3f& point = polylines[i].points[k];
+			maxValue = std::max(maxValue, std::abs(implicitFunctionValue(point, model)));
+			Eigen::Vector3f radial(point.x() - 150, point.y() - 100, 0);
+			check(std::abs(normals[i][k].norm() - 1.0f) < 1e-4f && normals[i][k].dot(radial) > 0.0f, "normal is not an outward unit vector");
+		}
+	}
+	check(maxValue <= 9e-4f, "projected points have |f| up to " + std::to_string(maxValue));
+}
+
+// 系数组合得到的隐函数等于各隐函数值的加权和，权重为0的隐函数不参与组合
+void testCombine(const ImplicitFunctionModel& model) {
+	std::vector<ImplicitFunctionModel> models(2, model);
+	for (auto& constraint : models[1].constraints) {
+		constraint.first.x() += 30.0f;
+	}
+	solveImplicitEquation(models[1].constraints, models[1].weights, models[1].P0, models[1].P);
+	const std::vector<float> weights = { 0.3f, 0.7f };
+	ImplicitFunctionModel combined;
+	combineImplicitFunctions(weights, models, combined);
+	check(combined.constraints.size() == 2 * model.constraints.size(), "combined model should hold the constraints of both models");
+	const Eigen::Vector3f points[] = { Eigen::Vector3f(150, 100, 0), Eigen::Vector3f(215, 95, 0), Eigen::Vector3f(20, 180, 0) };
+	for (const auto& point : points) {
+		float expected = weights[0] * implicitFunctionValue(point, models[0]) + weights[1] * implicitFunctionValue(point, models[1]);
+		float value = implicitFunctionValue(point, combined);
+		check(std::abs(value - expected) < 1e-3f * std::max(1.0f, std::abs(expected)),
+			"combined value " + std::to_string(value) + " differs from the weighted sum " + std::to_string(expected));
+	}
+	combineImplicitFunctions({ 0.0f, 1.0f }, models, combined);
+	check(combined.constraints.size() == model.constraints.size(), "a model with zero weight should be left out");
+}
+
+// 系数文件写入后读回，约束、权重和多项式系数不变
+void testModelFile(const ImplicitFunctionModel& model) {
+	std::filesystem::path path = std::filesystem::temp_directory_path() / "ImplicitFunctionTests_model.txt";
+	check(writeModelFile(path.string().c_str(), model), "writeModelFile() failed");
+	ImplicitFunctionModel loaded;
+	check(readModelFile(path.string().c_str(), loaded), "readModelFile() failed");
+	check(loaded.rows == model.rows && loaded.cols == model.cols && loaded.P0 == model.P0 && loaded.P == model.P,
+		"model file does not keep the size and polynomial coefficients");
+	check(loaded.constraints == model.constraints && loaded.weights == model.weights, "model file does not keep the constraints and weights");
+	std::filesystem::remove(path);
+	check(!readModelFile(path.string().c_str(), loaded), "reading a missing model file should fail");
+}
+
+int main() {
+	ImplicitFunctionModel model;
+	ellipseModel(model);
+	testGradient(model);
+	testRefinedZeroSet(model);
+	testCombine(model);
+	testModelFile(model);
+	return testResult();
+}
@@ -0,0 +1,119 @@
+﻿#include "../algorithm/InterpolationWorker.hpp"
+#include "TestUtility.hpp"
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+// 等待后台线程给出权重为weight的帧，超时返回nullptr
+FrameData* waitForFrame(InterpolationWorker& worker, float weight) {
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+	while (std::chrono::steady_clock::now() < deadline) {
+		FrameData* frame = worker.poll();
+		if (frame && frame->weight == weight) {
+			return frame;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	return nullptr;
+}
+
+// 队列满时push失败，先进先出；两个线程之间传递的元素不丢失、不乱序
+void testSpscQueue() {
+	SpscQueue<int, 4> queue;
+	bool pushed = true;
+	for (int i = 0; i < 4; i++) {
+		pushed &= queue.push(i);
+	}
+	check(pushed, "pushing into a queue with free slots failed");
+	check(!queue.push(4), "pushing into a full queue should fail");
+	int value = -1;
+	for (int i = 0; i < 4; i++) {
+		check(queue.pop(value) && value == i, "queue is not first in first out");
+	}
+	check(!queue.pop(value), "popping from an empty queue should fail");
+
+	const int count = 10000;
+	std::thread producer([&] {
+		for (int i = 0; i < count; i++) {
+			while (!queue.push(i)) {
+				std::this_thread::yield();
+			}
+		}
+	});
+	int expected = 0;
+	bool ordered = true;
+	while (expected < count) {
+		if (queue.pop(value)) {
+			ordered &= value == expected;
+			expected++;
+		}
+		else {
+			std::this_thread::yield();
+		}
+	}
+	producer.join();
+	check(ordered, "values passed between threads are lost or reordered");
+}
+
+// 计算只有被取消才会结束，最后一个权重除外：之前的每一次计算都被新的权重取消，最终显示最后一个权重的帧
+void testCancellation() {
+	const float last = 1.0f;
+	std::atomic<int> runs{ 0 }, cancels{ 0 };
+	InterpolationWorker worker([&](float weight, const CancelToken& cancel, FrameData& frame) {
+		runs++;
+		while (weight != last) {
+			if (cancel.cancelled()) {
+				cancels++;
+				return false;
+			}
+			std::this_thread::yield();
+		}
+		frame.pointCenterSize = sizeof(float);
+		frame.pointCenters.reserve(frame.pointCenterSize);
+		frame.pointCenters.data()[0] = weight;
+		return true;
+	});
+	for (int k = 0; k < 10; k++) {
+		worker.post(k * 0.1f);
+		std::this_thread::sleep_for(std::chrono::milliseconds(2));
+		check(worker.poll() == nullptr, "a cancelled task should not produce a frame");
+	}
+	worker.post(last);
+	FrameData* frame = waitForFrame(worker, last);
+	check(frame && frame->pointCenterSize == sizeof(float) && frame->pointCenters.data()[0] == last, "the last posted weight is never shown");
+	check(cancels.load() == runs.load() - 1, std::to_string(runs.load()) + " tasks ran but only " + std::to_string(cancels.load()) + " were cancelled");
+}
+
+// 渲染线程不取帧时所有帧缓冲都留在完成队列中，后台线程等待；poll()归还帧后后台线程继续计算最新的权重
+void testFramesReturned() {
+	std::atomic<int> runs{ 0 };
+	InterpolationWorker worker([&](float weight, const CancelToken&, FrameData& frame) {
+		runs++;
+		frame.pointCenterSize = 0;
+		return true;
+	});
+	for (int k = 0; k < FRAME_POOL_SIZE; k++) {
+		worker.post(static_cast<float>(k));
+		auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+		while (runs.load() <= k && std::chrono::steady_clock::now() < deadline) {
+			std::this_thread::yield();
+		}
+	}
+	check(runs.load() == FRAME_POOL_SIZE, "every frame buffer should have been filled");
+	// 此时没有空闲的帧缓冲，新的权重要等poll()归还帧之后才能计算
+	const float latest = 10.0f;
+	worker.post(latest);
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	check(runs.load() == FRAME_POOL_SIZE, "the worker should wait for a free frame buffer");
+	FrameData* frame = waitForFrame(worker, latest);
+	check(frame != nullptr, "the worker does not resume after poll() returns frame buffers");
+	check(runs.load() == FRAME_POOL_SIZE + 1, "the worker should compute the latest weight exactly once");
+}
+
+int main() {
+	testSpscQueue();
+	testCancellation();
+	testFramesReturned();
+	return testResult();
+}
@@ -0,0 +1,102 @@
+﻿#define DIMENSION 3
+#define MAX_MATRIX_DIMENSION 200
+
+#include "../algorithm/LinearSystem.hpp"
+#include "TestUtility.hpp"
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+// 分块LU分解与Eigen::PartialPivLU的解一致，n跨过LU_BLOCK_SIZE的整数倍以覆盖尾部子矩阵的更新
+template <typename T> void testBlockedLU(int n, double tolerance) {
+	std::mt19937 generator(n);
+	std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+	std::vector<T> A(n * n), B(n), X;
+	Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> eigenA(n, n);
+	Eigen::VectorXd eigenB(n);
+	for (int i = 0; i < n; i++) {
+		for (int j = 0; j < n; j++) {
+			A[i * n + j] = static_cast<T>(distribution(generator));
+			eigenA(i, j) = A[i * n + j];
+		}
+		B[i] = static_cast<T>(distribution(generator));
+		eigenB(i) = B[i];
+	}
+	solve(A, B, X, n);
+	Eigen::VectorXd expected = eigenA.partialPivLu().solve(eigenB);
+	double error = 0.0;
+	for (int i = 0; i < n; i++) {
+		error = std::max(error, std::abs(X[i] - expected(i)));
+	}
+	double scale = std::max(1.0, expected.cwiseAbs().maxCoeff());
+	check(error <= tolerance * scale, "blocked LU differs from Eigen by " + std::to_string(error) + " for n = " + std::to_string(n));
+
+	// 保存的分解可以对同一个矩阵再次求解
+	LUFactorization<T> factorization;
+	lu(A, factorization, n);
+	std::vector<T> again;
+	solve(factorization, B, again);
+	error = 0.0;
+	for (int i = 0; i < n; i++) {
+		error = std::max(error, std::abs(static_cast<double>(again[i] - X[i])));
+	}
+	check(error <= tolerance * scale, "solving with a stored factorization differs by " + std::to_string(error) + " for n = " + std::to_string(n));
+}
+
+// 主元为0的列跳过，对应的未知数取0：与DIMENSION为3而所有点z坐标都为0时一样，第1行和第1列都为0
+void testSingularColumn() {
+	int n = 3;
+	std::vector<double> A = { 2, 0, 1, 0, 0, 0, 1, 0, 3 }, B = { 3, 0, 4 }, X;
+	solve(A, B, X, n);
+	check(std::abs(X[0] - 1.0) < 1e-12 && X[1] == 0.0 && std::abs(X[2] - 1.0) < 1e-12, "zero pivot column is not skipped");
+}
+
+// 迭代改进：矩阵稍有变化时用旧的分解从旧的解出发收敛到新矩阵的解；用相反矩阵的分解时残差变大，判为发散
+void testRefine() {
+	int n = 80;
+	std::mt19937 generator(7);
+	std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+	std::vector<float> A(n * n), B(n), X;
+	for (int i = 0; i < n; i++) {
+		for (int j = 0; j < n; j++) {
+			A[i * n + j] = distribution(generator) + (i == j ? 4.0f : 0.0f);
+		}
+		B[i] = distribution(generator);
+	}
+	LUFactorization<float> factorization;
+	lu(A, factorization, n);
+	solve(factorization, B, X);
+
+	std::vector<float> perturbed(A), expected;
+	for (auto& a : perturbed) {
+		a += 1e-3f * distribution(generator);
+	}
+	solve(perturbed, B, expected, n);
+	std::vector<float> refined(X);
+	int iterations = 0;
+	check(refine(perturbed, B, factorization, refined, 8, 1e-5, iterations), "refinement should converge on a slightly perturbed matrix");
+	float error = 0.0f;
+	for (int i = 0; i < n; i++) {
+		error = std::max(error, std::abs(refined[i] - expected[i]));
+	}
+	check(iterations > 0 && iterations <= 8 && error < 1e-4f, "refined solution differs by " + std::to_string(error) + " after " + std::to_string(iterations) + " iterations");
+
+	std::vector<float> negated(A);
+	for (auto& a : negated) {
+		a = -a;
+	}
+	LUFactorization<float> wrong;
+	lu(negated, wrong, n);
+	std::vector<float> diverged(X);
+	check(!refine(perturbed, B, wrong, diverged, 8, 1e-5, iterations) && iterations == 1, "refinement with the negated factorization should stop as diverged");
+}
+
+int main() {
+	testBlockedLU<double>(150, 1e-9);
+	testBlockedLU<float>(150, 1e-3);
+	testSingularColumn();
+	testRefine();
+	return testResult();
+}
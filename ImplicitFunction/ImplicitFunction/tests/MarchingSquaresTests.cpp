@@ -0,0 +1,73 @@
+﻿#include "../algorithm/MarchingSquares.hpp"
+#include "TestUtility.hpp"
+#include <Eigen/Dense>
+#include <cmath>
+#include <string>
+#include <vector>
+
+// 两个单元格共享一条网格边：edges相同的端点连在一起
+MarchingSegment segment(int e0, int e1, Eigen::Vector3f p0, Eigen::Vector3f p1) {
+	return { { e0, e1 }, { p0, p1 } };
+}
+
+void testChainSegments() {
+	// 一个闭合的四边形（打乱顺序和方向）和一条由两条线段组成的开折线
+	std::vector<MarchingSegment> segments = {
+		segment(12, 13, Eigen::Vector3f(2, 1, 0), Eigen::Vector3f(1, 2, 0)),
+		segment(100, 101, Eigen::Vector3f(10, 0, 0), Eigen::Vector3f(11, 0, 0)),
+		segment(10, 11, Eigen::Vector3f(1, 0, 0), Eigen::Vector3f(0, 1, 0)),
+		segment(13, 11, Eigen::Vector3f(1, 2, 0), Eigen::Vector3f(0, 1, 0)),
+		segment(102, 101, Eigen::Vector3f(12, 0, 0), Eigen::Vector3f(11, 0, 0)),
+		segment(12, 10, Eigen::Vector3f(2, 1, 0), Eigen::Vector3f(1, 0, 0)),
+	};
+	std::vector<Polyline> polylines;
+	chainSegments(segments, polylines);
+	check(polylines.size() == 2, "chainSegments() should produce 2 polylines, got " + std::to_string(polylines.size()));
+	if (polylines.size() != 2) {
+		return;
+	}
+	const Polyline& open = polylines[0].closed ? polylines[1] : polylines[0];
+	const Polyline& closed = polylines[0].closed ? polylines[0] : polylines[1];
+	check(!open.closed && open.points.size() == 3, "open polyline should have 3 points");
+	check(closed.closed && closed.points.size() == 4, "closed polyline should have 4 points");
+	if (open.points.size() == 3) {
+		check(open.points[1] == Eigen::Vector3f(11, 0, 0), "open polyline is not chained through the shared edge");
+		check(std::abs(open.points[0].x() - open.points[2].x()) == 2.0f, "open polyline does not end at its free ends");
+	}
+	// 闭合折线相邻的点之间都有一条线段
+	for (size_t k = 0; k < closed.points.size(); k++) {
+		float distance = (closed.points[(k + 1) % closed.points.size()] - closed.points[k]).norm();
+		check(std::abs(distance - std::sqrt(2.0f)) < 1e-6f, "closed polyline skips a segment");
+	}
+}
+
+// 两个不相交的圆的采样值经marching squares得到两条闭合折线，点都在对应的圆附近，相邻的点不超过一个单元格
+void testCircles() {
+	int xNum = 81, yNum = 41;
+	float step = 1.0f, radius = 12.5f;
+	auto distance = [&](const Eigen::Vector2f& point, float centerX) {
+		return (point - Eigen::Vector2f(centerX, 20.0f)).norm();
+	};
+	std::vector<Polyline> circles;
+	marchingSquares([&](int i, int j) {
+		Eigen::Vector2f point(i * step, j * step);
+		return radius - std::min(distance(point, 20.0f), distance(point, 60.0f));
+	}, xNum, yNum, step, circles);
+	check(circles.size() == 2, "two circles should give two polylines, got " + std::to_string(circles.size()));
+	for (const auto& polyline : circles) {
+		check(polyline.closed, "a circle should give a closed polyline");
+		float centerX = polyline.points[0].x() < 40.0f ? 20.0f : 60.0f;
+		for (size_t k = 0; k < polyline.points.size(); k++) {
+			const Eigen::Vector3f& point = polyline.points[k];
+			check(std::abs(distance(point.head<2>(), centerX) - radius) < 0.1f, "marching squares point is off the circle");
+			const Eigen::Vector3f& next = polyline.points[(k + 1) % polyline.points.size()];
+			check((next - point).norm() <= std::sqrt(2.0f) * step + 1e-5f, "adjacent polyline points are not in the same cell");
+		}
+	}
+}
+
+int main() {
+	testChainSegments();
+	testCircles();
+	return testResult();
+}
@@ -0,0 +1,179 @@
+﻿#define DIMENSION 3
+#define MAX_MATRIX_DIMENSION 200
+
+#include "../algorithm/ModelCache.hpp"
+#include "TestUtility.hpp"
+#include <Eigen/Dense>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// 圆形边界的隐函数：40个边界约束和40个向内的法向约束
+void circleModel(ImplicitFunctionModel& model, std::vector<float>& field) {
+	model.rows = 60;
+	model.cols = 100;
+	for (int k = 0; k < 40; k++) {
+		float angle = 2.0f * static_cast<float>(EIGEN_PI) * k / 40;
+		model.constraints.emplace_back(Eigen::Vector3f(50 + 20 * std::cos(angle), 30 + 20 * std::sin(angle), 0), 0.0f);
+		model.constraints.emplace_back(Eigen::Vector3f(50 + 16 * std::cos(angle), 30 + 16 * std::sin(angle), 0), 1.0f);
+	}
+	solveImplicitEquation(model.constraints, model.weights, model.P0, model.P);
+	sampleImplicitFunction(model, field);
+}
+
+std::string readBytes(const std::filesystem::path& path) {
+	std::ifstream file(path, std::ios::binary);
+	return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+void writeBytes(const std::filesystem::path& path, const std::string& bytes) {
+	std::ofstream file(path, std::ios::binary);
+	file << bytes;
+}
+
+std::filesystem::path entryPath(const std::filesystem::path& directory, uint64_t key) {
+	char name[32];
+	snprintf(name, sizeof(name), "%016llx.cache", static_cast<unsigned long long>(key));
+	return directory / name;
+}
+
+// 保存后读取得到相同的模型和采样值
+void testRoundTrip(const std::filesystem::path& directory) {
+	ImplicitFunctionModel model;
+	std::vector<float> field;
+	circleModel(model, field);
+	ModelCache cache(directory.string());
+	cache.store(1, model, &field);
+	ImplicitFunctionModel loaded;
+	std::vector<float> loadedField;
+	check(cache.load(1, loaded, &loadedField), "a stored entry should hit");
+	check(loaded.rows == model.rows && loaded.cols == model.cols, "rows and cols differ after a round trip");
+	bool same = loaded.constraints.size() == model.constraints.size();
+	for (size_t k = 0; same && k < model.constraints.size(); k++) {
+		same = loaded.constraints[k] == model.constraints[k];
+	}
+	check(same, "constraints differ after a round trip");
+	check(loaded.weights == model.weights && loaded.P0 == model.P0 && loaded.P == model.P, "coefficients differ after a round trip");
+	check(loadedField == field, "field differs after a round trip");
+
+	// 没有保存采样值时，只有不需要采样值的读取命中
+	cache.store(2, model);
+	check(cache.load(2, loaded), "an entry without a field should hit when no field is requested");
+	check(!cache.load(2, loaded, &loadedField), "an entry without a field should miss when a field is requested");
+	check(!cache.load(3, loaded), "a missing entry should miss");
+
+	// 符号距离场的条目只有图片大小和采样值，没有约束和系数
+	ImplicitFunctionModel sdfModel;
+	sdfModel.rows = model.rows;
+	sdfModel.cols = model.cols;
+	cache.store(4, sdfModel, &field);
+	check(cache.load(4, loaded, &loadedField) && loaded.constraints.empty() && loaded.weights.size() == 0 && loadedField == field,
+		"a field-only entry should round trip without constraints");
+	const CacheStatistics& statistics = cache.getStatistics();
+	check(statistics.hits == 3 && statistics.misses == 2, "hits and misses are not counted");
+}
+
+// 截断或损坏的缓存文件都视为未命中，并且不改动传入的模型和采样值
+void testCorruption(const std::filesystem::path& directory) {
+	ImplicitFunctionModel model;
+	std::vector<float> field;
+	circleModel(model, field);
+	ModelCache cache(directory.string());
+	cache.store(1, model, &field);
+	std::filesystem::path path = entryPath(directory, 1);
+	std::string bytes = readBytes(path);
+	// 文件头为版本、rows、cols和约束个数，之后是每个约束的坐标和值、系数、P0、P以及采样值的个数
+	int constraintNum = static_cast<int>(model.constraints.size());
+	size_t fieldOffset = 16 + constraintNum * 16 + constraintNum * 4 + 4 + 12;
+	auto patch = [&](size_t offset, int value) {
+		std::string patched = bytes;
+		memcpy(&patched[offset], &value, sizeof(int));
+		return patched;
+	};
+	const std::pair<const char*, std::string> cases[] = {
+		{ "truncated field", bytes.substr(0, bytes.size() - 10) },
+		{ "truncated constraints", bytes.substr(0, 100) },
+		{ "version", patch(0, CACHE_VERSION + 1) },
+		{ "rows = 0", patch(4, 0) },
+		{ "cols = -5", patch(8, -5) },
+		{ "rows = 600", patch(4, 600) },
+		{ "1e9 constraints", patch(12, 1000000000) },
+		{ "-1 constraints", patch(12, -1) },
+		{ "197 constraints", patch(12, 197) },
+		{ "field size 7", patch(fieldOffset, 7) },
+		{ "field size -7", patch(fieldOffset, -7) },
+	};
+	for (const auto& [name, corrupted] : cases) {
+		writeBytes(path, corrupted);
+		ImplicitFunctionModel loaded;
+		loaded.rows = -1;
+		std::vector<float> loadedField = { 1.0f };
+		check(!cache.load(1, loaded, &loadedField), std::string("corrupted entry (") + name + ") should miss");
+		check(loaded.rows == -1 && loaded.constraints.empty() && loadedField.size() == 1,
+			std::string("corrupted entry (") + name + ") changed the output");
+	}
+	writeBytes(path, bytes);
+	ImplicitFunctionModel loaded;
+	std::vector<float> loadedField;
+	check(cache.load(1, loaded, &loadedField) && loadedField == field, "the intact entry should still hit");
+}
+
+// 总大小超过上限时淘汰最久未使用的缓存文件，读取会更新使用时间
+void testEviction(const std::filesystem::path& directory) {
+	ImplicitFunctionModel model;
+	std::vector<float> field;
+	circleModel(model, field);
+	{
+		ModelCache sizing(directory.string());
+		sizing.store(0, model, &field);
+	}
+	uintmax_t entrySize = std::filesystem::file_size(entryPath(directory, 0));
+	std::filesystem::remove(entryPath(directory, 0));
+
+	ModelCache cache(directory.string(), entrySize * 5 / 2);
+	cache.store(1, model, &field);
+	cache.store(2, model, &field);
+	// 显式设置修改时间，不依赖文件系统的时间精度
+	auto now = std::filesystem::file_time_type::clock::now();
+	std::filesystem::last_write_time(entryPath(directory, 1), now - std::chrono::hours(2));
+	std::filesystem::last_write_time(entryPath(directory, 2), now - std::chrono::hours(1));
+	ImplicitFunctionModel loaded;
+	check(cache.load(1, loaded), "entry 1 should hit before eviction");
+	cache.store(3, model, &field);
+	check(std::filesystem::exists(entryPath(directory, 1)), "the recently used entry should be kept");
+	check(!std::filesystem::exists(entryPath(directory, 2)), "the least recently used entry should be evicted");
+	check(std::filesystem::exists(entryPath(directory, 3)), "the new entry should be kept");
+	check(cache.getStatistics().evictions == 1, "evictions are not counted");
+}
+
+// 键由文件内容决定，与路径无关
+void testKey(const std::filesystem::path& directory) {
+	writeBytes(directory / "a.png", "image a");
+	writeBytes(directory / "b.png", "image a");
+	writeBytes(directory / "c.png", "image c");
+	ModelCache cache(directory.string());
+	uint64_t a, b, c, missing;
+	check(cache.key((directory / "a.png").string().c_str(), a) && cache.key((directory / "b.png").string().c_str(), b) &&
+		cache.key((directory / "c.png").string().c_str(), c), "key() failed on an existing file");
+	check(a == b, "files with the same content should have the same key");
+	check(a != c, "files with different content should have different keys");
+	check(!cache.key((directory / "missing.png").string().c_str(), missing), "key() should fail on a missing file");
+}
+
+int main() {
+	std::filesystem::path root = std::filesystem::temp_directory_path() / "ModelCacheTests";
+	const char* names[] = { "roundtrip", "corruption", "eviction", "key" };
+	void (*tests[])(const std::filesystem::path&) = { testRoundTrip, testCorruption, testEviction, testKey };
+	for (int k = 0; k < 4; k++) {
+		std::filesystem::path directory = root / names[k];
+		std::filesystem::remove_all(directory);
+		std::filesystem::create_directories(directory);
+		tests[k](directory);
+	}
+	std::filesystem::remove_all(root);
+	return testResult();
+}
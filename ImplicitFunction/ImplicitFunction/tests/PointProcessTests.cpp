@@ -0,0 +1,268 @@
+﻿#include "../algorithm/PointProcess.hpp"
+#include "TestUtility.hpp"
+#include <Eigen/Dense>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+// 原来的凹包：所有点对中距离的平方小于ALPHA * 2的为候选，只和points[i]的候选点比较，作为对照
+void allPairsConcaveHull(const std::vector<Eigen::Vector3f>& points, std::vector<int>& retPointIndexes, std::vector<std::pair<int, int>>& retEdgeIndexes) {
+	int n = points.size();
+	std::vector<std::vector<int>> candPoints(n);
+	for (int i = 0; i < n; i++) {
+		for (int j = i + 1; j < n; j++) {
+			if ((points[i] - points[j]).squaredNorm() < ALPHA * 2) {
+				candPoints[i].push_back(j);
+				candPoints[j].push_back(i);
+			}
+		}
+	}
+	for (int i = 0; i < n; i++) {
+		for (int j = 0; j < candPoints[i].size(); j++) {
+			if (candPoints[i][j] <= i) {
+				continue;
+			}
+			Eigen::Vector3f c1, c2;
+			circleCenterCalc(points[i], points[candPoints[i][j]], c1, c2);
+			bool flag1 = true, flag2 = true;
+			for (int k = 0; k < candPoints[i].size(); k++) {
+				if (candPoints[i][k] != candPoints[i][j]) {
+					if ((c1 - points[candPoints[i][k]]).norm() <= ALPHA) {
+						flag1 = false;
+					}
+					if ((c2 - points[candPoints[i][k]]).norm() <= ALPHA) {
+						flag2 = false;
+					}
+				}
+			}
+			if (flag1 || flag2) {
+				retPointIndexes.emplace_back(i);
+				retEdgeIndexes.emplace_back(std::make_pair(i, candPoints[i][j]));
+			}
+		}
+	}
+}
+
+// 带噪声的椭圆环带
+std::vector<Eigen::Vector3f> band(int n, unsigned seed) {
+	std::mt19937 random(seed);
+	std::uniform_real_distribution<float> angle(0.0f, 2.0f * static_cast<float>(EIGEN_PI)), noise(-3.0f, 3.0f);
+	std::vector<Eigen::Vector3f> points;
+	for (int i = 0; i < n; i++) {
+		float t = angle(random);
+		float r = 200.0f + (i % 7) * 1.3f + noise(random);
+		points.emplace_back(500.0f + r * std::cos(t), 300.0f + 0.7f * r * std::sin(t), 0.0f);
+	}
+	return points;
+}
+
+// 螺旋线，相邻两圈的间距逐渐变大
+std::vector<Eigen::Vector3f> spiral(int n) {
+	std::vector<Eigen::Vector3f> points;
+	float t = 0.0f;
+	for (int i = 0; i < n; i++) {
+		float r = 50.0f + 3.0f * t;
+		points.emplace_back(500.0f + r * std::cos(t), 300.0f + r * std::sin(t), 0.0f);
+		t += 1.0f / r;
+	}
+	return points;
+}
+
+// 网格加速的凹包与原来的结果完全相同（包括顺序），缓冲跨调用重复使用时也相同
+void testConcaveHull() {
+	const std::vector<std::vector<Eigen::Vector3f>> pointSets = { band(2000, 3), spiral(1500), band(300, 7) };
+	ConcaveHullScratch scratch;
+	for (size_t s = 0; s < pointSets.size(); s++) {
+		std::vector<int> pointIndexes, expectedPointIndexes;
+		std::vector<std::pair<int, int>> edgeIndexes, expectedEdgeIndexes;
+		ConcaveHull(pointSets[s], pointIndexes, edgeIndexes, scratch);
+		allPairsConcaveHull(pointSets[s], expectedPointIndexes, expectedEdgeIndexes);
+		std::string name = "point set " + std::to_string(s) + ": ";
+		check(!expectedEdgeIndexes.empty(), name + "the baseline should find hull edges");
+		check(edgeIndexes == expectedEdgeIndexes, name + "ConcaveHull gives " + std::to_string(edgeIndexes.size())
+			+ " edges, the all-pairs baseline gives " + std::to_string(expectedEdgeIndexes.size()));
+		check(pointIndexes == expectedPointIndexes, name + "ConcaveHull point indexes differ from the all-pairs baseline");
+	}
+}
+
+// 凸包与期望的点逐个相同：ConvexHullInPlace()的结果按逆时针排列，从字典序最小的点开始，不含共线的点
+bool sameHull(const std::vector<Eigen::Vector3f>& hull, const std::vector<Eigen::Vector3f>& expected) {
+	if (hull.size() != expected.size()) {
+		return false;
+	}
+	for (size_t k = 0; k < hull.size(); k++) {
+		if ((hull[k] - expected[k]).norm() > 1e-5f) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void testConvexHull() {
+	// 10 × 10的整数网格：边上共线的点和内部的点都不在凸包上
+	std::vector<Eigen::Vector3f> grid;
+	for (int x = 0; x < 10; x++) {
+		for (int y = 0; y < 10; y++) {
+			grid.emplace_back(x, y, 0);
+		}
+	}
+	std::mt19937 generator(1);
+	std::shuffle(grid.begin(), grid.end(), generator);
+	size_t size = ConvexHullInPlace(grid);
+	grid.resize(size);
+	check(sameHull(grid, { Eigen::Vector3f(0, 0, 0), Eigen::Vector3f(9, 0, 0), Eigen::Vector3f(9, 9, 0), Eigen::Vector3f(0, 9, 0) }),
+		"convex hull of a grid should be its 4 corners");
+
+	// 重合的点
+	std::vector<Eigen::Vector3f> same(5, Eigen::Vector3f(3, 4, 0));
+	check(ConvexHullInPlace(same) == 1, "convex hull of coincident points should have 1 point");
+
+	// 超过CONVEX_HULL_CHUNK个点时分块并行：[-0.7, 0.7]的正方形内的随机点加上半径为2的正16边形的顶点，凸包就是这16个顶点
+	// 第二次使用同一个hullSizes，结果相同
+	int sides = 16;
+	std::vector<Eigen::Vector3f> expected, points;
+	for (int k = 0; k < sides; k++) {
+		double angle = 2.0 * EIGEN_PI * k / sides - EIGEN_PI;
+		expected.emplace_back(static_cast<float>(2.0 * std::cos(angle)), static_cast<float>(2.0 * std::sin(angle)), 0.0f);
+	}
+	std::uniform_real_distribution<float> distribution(-0.7f, 0.7f);
+	for (int i = 0; i < CONVEX_HULL_CHUNK + CONVEX_HULL_CHUNK / 2; i++) {
+		points.emplace_back(distribution(generator), distribution(generator), 0.0f);
+	}
+	points.insert(points.end(), expected.begin(), expected.end());
+	std::vector<size_t> hullSizes;
+	for (int pass = 0; pass < 2; pass++) {
+		std::vector<Eigen::Vector3f> shuffled = points;
+		std::shuffle(shuffled.begin(), shuffled.end(), generator);
+		shuffled.resize(ConvexHullInPlace(shuffled, hullSizes));
+		// 期望的凸包从字典序最小的点(-2, 0)开始，逆时针即角度递增
+		check(sameHull(shuffled, expected), "chunked convex hull should be the 16 polygon vertices, got " + std::to_string(shuffled.size()) + " points");
+	}
+	check(hullSizes.size() == 2, "chunked convex hull should record the hull size of each chunk");
+}
+
+// 逐个三元组检查外接圆是否为空得到Delaunay三角形，只用于少量的点
+std::vector<std::array<int, 3>> bruteForceDelaunay(const std::vector<Eigen::Vector3f>& points) {
+	int n = points.size();
+	std::vector<std::array<int, 3>> triangles;
+	for (int a = 0; a < n; a++) {
+		for (int b = a + 1; b < n; b++) {
+			for (int c = b + 1; c < n; c++) {
+				double ax = points[a][0], ay = points[a][1], bx = points[b][0], by = points[b][1], cx = points[c][0], cy = points[c][1];
+				double d = 2.0 * (ax * (by - cy) + bx * (cy - ay) + cx * (ay - by));
+				if (std::abs(d) < 1e-9) {
+					continue;
+				}
+				double ux = ((ax * ax + ay * ay) * (by - cy) + (bx * bx + by * by) * (cy - ay) + (cx * cx + cy * cy) * (ay - by)) / d;
+				double uy = ((ax * ax + ay * ay) * (cx - bx) + (bx * bx + by * by) * (ax - cx) + (cx * cx + cy * cy) * (bx - ax)) / d;
+				double r2 = (ax - ux) * (ax - ux) + (ay - uy) * (ay - uy);
+				bool empty = true;
+				for (int o = 0; o < n && empty; o++) {
+					double dx = points[o][0] - ux, dy = points[o][1] - uy;
+					empty = o == a || o == b || o == c || dx * dx + dy * dy >= r2 * (1.0 - 1e-9);
+				}
+				if (empty) {
+					triangles.push_back({ a, b, c });
+				}
+			}
+		}
+	}
+	return triangles;
+}
+
+// 半径为alpha时的边界：边长的平方小于alpha * 2，且两个过端点、半径为alpha的圆中有一个不包含其他任何点
+std::vector<std::pair<int, int>> emptyCircleEdges(const std::vector<Eigen::Vector3f>& points, float alpha) {
+	int n = points.size();
+	std::vector<std::pair<int, int>> edges;
+	for (int i = 0; i < n; i++) {
+		for (int j = i + 1; j < n; j++) {
+			double dx = points[j][0] - points[i][0], dy = points[j][1] - points[i][1];
+			double d2 = dx * dx + dy * dy;
+			if (d2 >= alpha * 2.0 || d2 > 4.0 * alpha * alpha) {
+				continue;
+			}
+			double h = std::sqrt(alpha * alpha / d2 - 0.25);
+			double mx = (points[i][0] + points[j][0]) / 2.0, my = (points[i][1] + points[j][1]) / 2.0;
+			bool found = false;
+			for (int side = -1; side <= 1 && !found; side += 2) {
+				double cx = mx - side * h * dy, cy = my + side * h * dx;
+				bool empty = true;
+				for (int o = 0; o < n && empty; o++) {
+					double ex = points[o][0] - cx, ey = points[o][1] - cy;
+					empty = o == i || o == j || ex * ex + ey * ey >= alpha * alpha * (1.0 - 1e-6);
+				}
+				found = empty;
+			}
+			if (found) {
+				edges.emplace_back(i, j);
+			}
+		}
+	}
+	return edges;
+}
+
+// 每条边的α区间与逐个α检查空圆的结果一致
+void testAlphaShapeIntervals() {
+	std::mt19937 random(5);
+	std::uniform_real_distribution<float> coordinate(0.0f, 100.0f);
+	AlphaShape shape;
+	for (int trial = 0; trial < 10; trial++) {
+		std::vector<Eigen::Vector3f> points;
+		for (int i = 0; i < 40; i++) {
+			points.emplace_back(coordinate(random), coordinate(random), 0.0f);
+		}
+		shape.buildFromTriangles(points, bruteForceDelaunay(points));
+		for (float alpha : { 10.0f, 25.0f, 60.0f, 150.0f, 500.0f, 2000.0f }) {
+			std::vector<int> pointIndexes;
+			std::vector<std::pair<int, int>> edgeIndexes;
+			shape.extract(alpha, pointIndexes, edgeIndexes);
+			std::vector<std::pair<int, int>> expected = emptyCircleEdges(points, alpha);
+			check(edgeIndexes == expected, "trial " + std::to_string(trial) + ", alpha " + std::to_string(alpha) + ": extract() gives "
+				+ std::to_string(edgeIndexes.size()) + " edges, the empty circle test gives " + std::to_string(expected.size()));
+			check(pointIndexes.size() == edgeIndexes.size(), "extract() should write the first end of every edge as a point");
+		}
+	}
+}
+
+// 沿轮廓均匀采样、交错排成两行的点：α = ALPHA时与ConcaveHull()的结果完全相同；
+// 随机分布的点：α = ALPHA时的边都在ConcaveHull()的结果中，ConcaveHull()只检查距离sqrt(ALPHA * 2)以内的点，会多出圆内有更远的点的边
+void testAlphaShapeDefault() {
+	std::mt19937 random(11);
+	std::uniform_real_distribution<float> angle(0.0f, 2.0f * static_cast<float>(EIGEN_PI)), noise(-1.0f, 1.0f);
+	std::vector<Eigen::Vector3f> regularPoints, randomPoints;
+	for (int i = 0; i < 300; i++) {
+		float t = 2.0f * static_cast<float>(EIGEN_PI) * i / 300, r = 250.0f + (i % 2 ? 1.0f : -1.0f) + 0.01f * (i % 7);
+		regularPoints.emplace_back(500.0f + r * std::cos(t), 300.0f + r * std::sin(t), 0.0f);
+		t = angle(random);
+		r = 250.0f + noise(random);
+		randomPoints.emplace_back(500.0f + r * std::cos(t), 300.0f + r * std::sin(t), 0.0f);
+	}
+	AlphaShape shape;
+	for (bool regular : { true, false }) {
+		const std::vector<Eigen::Vector3f>& points = regular ? regularPoints : randomPoints;
+		shape.buildFromTriangles(points, bruteForceDelaunay(points));
+		std::vector<int> pointIndexes, hullPointIndexes;
+		std::vector<std::pair<int, int>> edgeIndexes, hullEdgeIndexes;
+		shape.extract(ALPHA, pointIndexes, edgeIndexes);
+		ConcaveHull(points, hullPointIndexes, hullEdgeIndexes);
+		std::string name = regular ? "regular ring: " : "random ring: ";
+		check(!edgeIndexes.empty(), name + "extract(ALPHA) should find boundary edges");
+		check(std::includes(hullEdgeIndexes.begin(), hullEdgeIndexes.end(), edgeIndexes.begin(), edgeIndexes.end()),
+			name + "every edge of extract(ALPHA) should be a ConcaveHull() edge");
+		if (regular) {
+			check(edgeIndexes == hullEdgeIndexes && pointIndexes == hullPointIndexes, name + "extract(ALPHA) gives " + std::to_string(edgeIndexes.size())
+				+ " edges, ConcaveHull() gives " + std::to_string(hullEdgeIndexes.size()));
+		}
+	}
+}
+
+int main() {
+	testConvexHull();
+	testConcaveHull();
+	testAlphaShapeIntervals();
+	testAlphaShapeDefault();
+	return testResult();
+}
@@ -0,0 +1,109 @@
+﻿#define DIMENSION 3
+#define MAX_MATRIX_DIMENSION 200
+
+#include "../algorithm/SvgProcess.hpp"
+#include "TestUtility.hpp"
+#include <Eigen/Dense>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+void testParseSvgPath() {
+	std::vector<SvgSubpath> subpaths;
+	check(parseSvgPath("M 10 10 h 20 v 20 H 10 Z m 40 40 Q 60 40 70 50 T 90 50 C 90 60 80 70 70 70 S 50 60 50 50 z", subpaths),
+		"parseSvgPath() rejected a valid path");
+	check(subpaths.size() == 2, "path should have 2 subpaths");
+	if (subpaths.size() != 2) {
+		return;
+	}
+	// 第一个子路径：3条直线加上闭合的一条
+	const auto& square = subpaths[0].segments;
+	check(square.size() == 4, "square should have 4 segments");
+	if (square.size() == 4) {
+		check(square[0].order == 1 && square[0].points[1] == Eigen::Vector2f(30, 10), "relative h is wrong");
+		check(square[1].points[1] == Eigen::Vector2f(30, 30), "relative v is wrong");
+		check(square[2].points[1] == Eigen::Vector2f(10, 30), "absolute H is wrong");
+		check(square[3].points[0] == Eigen::Vector2f(10, 30) && square[3].points[1] == Eigen::Vector2f(10, 10), "Z should close the subpath");
+	}
+	// 第二个子路径：Z之后的m相对于子路径的起点，T和S的控制点为上一个控制点的反射，终点与起点重合时不再添加直线
+	const auto& curves = subpaths[1].segments;
+	check(curves.size() == 4, "curve subpath should have 4 segments");
+	if (curves.size() == 4) {
+		check(curves[0].order == 2 && curves[0].points[0] == Eigen::Vector2f(50, 50), "m after Z should start at the subpath start");
+		check(curves[1].order == 2 && curves[1].points[1] == Eigen::Vector2f(80, 60), "T should reflect the previous control point");
+		check(curves[2].order == 3 && curves[2].points[3] == Eigen::Vector2f(70, 70), "C end point is wrong");
+		check(curves[3].order == 3 && curves[3].points[1] == Eigen::Vector2f(60, 70), "S should reflect the previous control point");
+	}
+
+	std::vector<SvgSubpath> arcs;
+	check(!parseSvgPath("M 0 0 A 10 10 0 0 1 20 0", arcs), "arcs are not supported and should be rejected");
+}
+
+// 写入临时的SVG文件并用processSvg()取约束点
+bool processSvgText(const std::string& text, int& rows, int& cols,
+	std::vector<Eigen::Vector2f>& boundaryPoints, std::vector<Eigen::Vector2f>& normalPoints) {
+	std::filesystem::path path = std::filesystem::temp_directory_path() / "SvgProcessTests.svg";
+	{
+		std::ofstream file(path);
+		file << text;
+	}
+	bool result = processSvg(path.string().c_str(), rows, cols, boundaryPoints, normalPoints);
+	std::filesystem::remove(path);
+	return result;
+}
+
+// viewBox换算为像素坐标；带孔的正方形上，边界约束点都在边上，法向约束点都在填充区域内（孔的法向指向孔外）
+void testProcessSvgHole() {
+	int rows = 0, cols = 0;
+	std::vector<Eigen::Vector2f> boundaryPoints, normalPoints;
+	check(processSvgText("<svg width=\"200\" height=\"200\" viewBox=\"0 0 100 100\">"
+		"<path d=\"M 10 10 H 90 V 90 H 10 Z M 30 30 H 70 V 70 H 30 Z\"/></svg>", rows, cols, boundaryPoints, normalPoints),
+		"processSvg() failed on a square with a hole");
+	check(rows == 200 && cols == 200, "SVG size should come from width and height");
+	check(!boundaryPoints.empty() && boundaryPoints.size() <= SAMPLE_NUM && boundaryPoints.size() == normalPoints.size(),
+		"square with a hole should give at most SAMPLE_NUM boundary points, got " + std::to_string(boundaryPoints.size()));
+	std::vector<Eigen::Vector2f> outer = { { 20, 20 }, { 180, 20 }, { 180, 180 }, { 20, 180 } };
+	std::vector<Eigen::Vector2f> hole = { { 60, 60 }, { 140, 60 }, { 140, 140 }, { 60, 140 } };
+	int offEdge = 0, outside = 0;
+	for (size_t i = 0; i < boundaryPoints.size(); i++) {
+		float distance = FLT_MAX;
+		for (const auto* polygon : { &outer, &hole }) {
+			for (int k = 0; k < 4; k++) {
+				distance = std::min(distance, segmentDistance(boundaryPoints[i], (*polygon)[k], (*polygon)[(k + 1) % 4]));
+			}
+		}
+		offEdge += distance > 1e-3f;
+		outside += !insidePolyline(outer, normalPoints[i]) || insidePolyline(hole, normalPoints[i]);
+	}
+	check(offEdge == 0, std::to_string(offEdge) + " boundary points are not on the square edges");
+	check(outside == 0, std::to_string(outside) + " normal points are outside the filled region");
+}
+
+// 子路径很多时每条至少3个点也放不下，总数不超过SAMPLE_NUM，丢弃最短的子路径
+void testProcessSvgSampleCap() {
+	std::string data;
+	for (int i = 0; i < 30; i++) {
+		float size = 2.0f + i * 0.1f;
+		data += "M " + std::to_string(i * 10) + " 10 h " + std::to_string(size) + " v " + std::to_string(size) + " h -" + std::to_string(size) + " Z ";
+	}
+	int rows = 0, cols = 0;
+	std::vector<Eigen::Vector2f> boundaryPoints, normalPoints;
+	check(processSvgText("<svg width=\"320\" height=\"20\"><path d=\"" + data + "\"/></svg>", rows, cols, boundaryPoints, normalPoints),
+		"processSvg() failed on many small subpaths");
+	check(boundaryPoints.size() <= SAMPLE_NUM, "sample total " + std::to_string(boundaryPoints.size()) + " exceeds SAMPLE_NUM");
+	check(boundaryPoints.size() == SAMPLE_NUM / 3 * 3, "every kept subpath should get 3 points, got " + std::to_string(boundaryPoints.size()) + " points");
+	// 最短的子路径在最左边，被丢弃后第一个点在保留下来的子路径上
+	float minX = FLT_MAX;
+	for (const auto& point : boundaryPoints) {
+		minX = std::min(minX, point.x());
+	}
+	check(minX >= (30 - SAMPLE_NUM / 3) * 10.0f, "the shortest subpaths should be dropped first");
+}
+
+int main() {
+	testParseSvgPath();
+	testProcessSvgHole();
+	testProcessSvgSampleCap();
+	return testResult();
+}
@@ -0,0 +1,28 @@
+﻿#ifndef __TEST_UTILITY_HPP__
+#define __TEST_UTILITY_HPP__
+
+#include <iostream>
+#include <string>
+
+// 算法头文件的确定性测试：随机数使用固定的种子，检查失败时输出原因，有失败的检查时返回1，由ctest运行
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& message) {
+	if (!condition) {
+		std::cerr << "FAILED: " << message << std::endl;
+		failures++;
+	}
+}
+
+// main()的返回值
+static int testResult() {
+	if (failures > 0) {
+		std::cerr << failures << " checks failed" << std::endl;
+		return 1;
+	}
+	std::cout << "All tests passed" << std::endl;
+	return 0;
+}
+
+#endif
@@ -0,0 +1,109 @@
+﻿#define DIMENSION 3
+#define MAX_MATRIX_DIMENSION 200
+
+#include "../algorithm/ImplicitFunction.hpp"
+#include "../algorithm/TiledField.hpp"
+#include "TestUtility.hpp"
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+// 两个部分重叠的圆形采样值，第二个带有正弦扰动；网格大小不是TILE_SIZE的整数倍
+void fields(int xNum, int yNum, std::vector<float>& values_1, std::vector<float>& values_2) {
+	values_1.resize(xNum * yNum);
+	values_2.resize(xNum * yNum);
+	for (int i = 0; i < xNum; i++) {
+		for (int j = 0; j < yNum; j++) {
+			values_1[i * yNum + j] = 120.0f - std::hypot(i * 2.0f - 260.0f, j * 2.0f - 200.0f);
+			values_2[i * yNum + j] = 90.0f - std::hypot(i * 2.0f - 360.0f, j * 2.0f - 180.0f) + 15.0f * std::sin(i * 0.2f);
+		}
+	}
+}
+
+// 分块后的取值与原数组相同，每块的最值恰好是块内所有单元格角点（包括多出的一行一列）的最值
+void testLayout(const std::vector<float>& values, int xNum, int yNum) {
+	TiledField field(values.data(), xNum, yNum);
+	bool same = true;
+	for (int i = 0; i < xNum; i++) {
+		for (int j = 0; j < yNum; j++) {
+			same &= field.at(i, j) == values[i * yNum + j];
+		}
+	}
+	check(same, "TiledField::at() differs from the row-major values");
+	for (int tx = 0; tx < field.xTiles; tx++) {
+		for (int ty = 0; ty < field.yTiles; ty++) {
+			int i0, i1, j0, j1;
+			field.tileCells(tx, ty, i0, i1, j0, j1);
+			float minValue = values[i0 * yNum + j0], maxValue = minValue;
+			for (int i = i0; i <= i1; i++) {
+				for (int j = j0; j <= j1; j++) {
+					minValue = std::min(minValue, values[i * yNum + j]);
+					maxValue = std::max(maxValue, values[i * yNum + j]);
+				}
+			}
+			int tile = tx * field.yTiles + ty;
+			check(field.minValues[tile] == minValue && field.maxValues[tile] == maxValue,
+				"bounds of tile (" + std::to_string(tx) + ", " + std::to_string(ty) + ") do not match its corner samples");
+		}
+	}
+}
+
+// 折线上的所有点，排序后用于比较
+std::vector<Eigen::Vector3f> sortedPoints(const std::vector<Polyline>& polylines) {
+	std::vector<Eigen::Vector3f> points;
+	for (const auto& polyline : polylines) {
+		points.insert(points.end(), polyline.points.begin(), polyline.points.end());
+	}
+	std::sort(points.begin(), points.end(), [](const Eigen::Vector3f& a, const Eigen::Vector3f& b) {
+		return a.x() != b.x() ? a.x() < b.x() : a.y() < b.y();
+	});
+	return points;
+}
+
+// 与implicitFunctionInterpolation()相同的剔除方式：混合值在块内的范围不跨过0时跳过该块，
+// 结果与在完整网格上做marching squares相同
+void testCulledBlend(const std::vector<float>& values_1, const std::vector<float>& values_2, int xNum, int yNum) {
+	TiledField field_1(values_1.data(), xNum, yNum), field_2(values_2.data(), xNum, yNum);
+	for (float weight : { 0.0f, 0.3f, 0.5f, 0.8f, 1.0f }) {
+		float weight_1 = weight, weight_2 = 1.0f - weight;
+		auto value = [&](int i, int j) {
+			return weight_1 * field_1.at(i, j) + weight_2 * field_2.at(i, j);
+		};
+		std::vector<MarchingSegment> segments;
+		int culled = 0;
+		for (int tile = 0; tile < field_1.xTiles * field_1.yTiles; tile++) {
+			float minValue = weight_1 * field_1.minValues[tile] + weight_2 * field_2.minValues[tile];
+			float maxValue = weight_1 * field_1.maxValues[tile] + weight_2 * field_2.maxValues[tile];
+			if (minValue > 0.0f || maxValue <= 0.0f) {
+				culled++;
+				continue;
+			}
+			int i0, i1, j0, j1;
+			field_1.tileCells(tile / field_1.yTiles, tile % field_1.yTiles, i0, i1, j0, j1);
+			marchingSquaresCells(value, field_1.yNum, STEP, i0, i1, j0, j1, segments);
+		}
+		std::vector<Polyline> tiled, dense;
+		chainSegments(segments, tiled);
+		marchingSquares([&](int i, int j) {
+			return weight_1 * values_1[i * yNum + j] + weight_2 * values_2[i * yNum + j];
+		}, xNum, yNum, STEP, dense);
+		std::string name = "weight " + std::to_string(weight) + ": ";
+		check(culled > 0, name + "no tile was culled");
+		check(!dense.empty(), name + "the blend should have a zero set");
+		check(tiled.size() == dense.size(), name + "culled blend gives " + std::to_string(tiled.size())
+			+ " polylines, dense blend gives " + std::to_string(dense.size()));
+		check(sortedPoints(tiled) == sortedPoints(dense), name + "culled blend differs from the dense blend");
+	}
+}
+
+int main() {
+	int xNum = 250, yNum = 190;
+	std::vector<float> values_1, values_2;
+	fields(xNum, yNum, values_1, values_2);
+	testLayout(values_1, xNum, yNum);
+	testLayout(values_2, xNum, yNum);
+	testCulledBlend(values_1, values_2, xNum, yNum);
+	return testResult();
+}
@@ -0,0 +1,55 @@
+﻿#include "../algorithm/VertexArena.hpp"
+#include "TestUtility.hpp"
+#include <string>
+#include <vector>
+
+// 容量从ARENA_INITIAL_SIZE开始按2倍增长，不超过容量的请求不重新分配，预算记录所有内存池的容量之和
+void testGrowth() {
+	ArenaBudget budget(ARENA_INITIAL_SIZE * 16);
+	{
+		VertexArena arena(budget);
+		check(arena.reserve(100) && arena.getCapacity() == ARENA_INITIAL_SIZE, "the first reserve should allocate ARENA_INITIAL_SIZE bytes");
+		const float* memory = arena.data();
+		check(arena.reserve(ARENA_INITIAL_SIZE) && arena.data() == memory, "a request within the capacity should keep the memory");
+		check(arena.reserve(ARENA_INITIAL_SIZE * 3) && arena.getCapacity() == ARENA_INITIAL_SIZE * 4, "the capacity should double until it fits");
+		check(arena.reserve(10) && arena.getCapacity() == ARENA_INITIAL_SIZE * 4, "the capacity should not shrink");
+		check(arena.getHighWater() == ARENA_INITIAL_SIZE * 3, "arena high water should be the largest request");
+		VertexArena other(budget);
+		other.reserve(1);
+		check(budget.getUsed() == ARENA_INITIAL_SIZE * 5, "budget should count the capacity of every arena, got " + std::to_string(budget.getUsed()));
+	}
+	check(budget.getUsed() == 0, "destroyed arenas should return their capacity to the budget");
+	check(budget.getHighWater() == ARENA_INITIAL_SIZE * 5, "budget high water should be the largest total capacity");
+}
+
+// 按2倍增长超出预算时只申请需要的大小，仍超出预算时失败且原有内存不变
+void testBudget() {
+	ArenaBudget budget(ARENA_INITIAL_SIZE * 3);
+	VertexArena arena(budget);
+	check(arena.reserve(ARENA_INITIAL_SIZE * 2), "reserving within the budget failed");
+	check(arena.reserve(ARENA_INITIAL_SIZE * 3) && arena.getCapacity() == ARENA_INITIAL_SIZE * 3,
+		"growth past the budget should fall back to the requested size");
+	const float* memory = arena.data();
+	check(!arena.reserve(ARENA_INITIAL_SIZE * 3 + 1), "reserving past the budget should fail");
+	check(arena.data() == memory && arena.getCapacity() == ARENA_INITIAL_SIZE * 3, "a failed reserve should keep the memory");
+}
+
+// 关联外部内存时释放自己的内存并且不计入预算，放不下时改回自己分配的内存
+void testAttach() {
+	ArenaBudget budget(ARENA_INITIAL_SIZE * 4);
+	VertexArena arena(budget);
+	arena.reserve(1);
+	std::vector<float> external(256);
+	arena.attach(external.data(), external.size() * sizeof(float));
+	check(arena.data() == external.data() && budget.getUsed() == 0, "attached memory should be used and not charged to the budget");
+	check(arena.reserve(100 * sizeof(float)) && arena.data() == external.data(), "a request that fits should stay in the attached memory");
+	check(arena.reserve(1024 * sizeof(float)) && arena.data() != external.data(), "a request that does not fit should use owned memory");
+	check(budget.getUsed() == arena.getCapacity(), "owned memory should be charged to the budget again");
+}
+
+int main() {
+	testGrowth();
+	testBudget();
+	testAttach();
+	return testResult();
+}